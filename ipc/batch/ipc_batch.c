@@ -0,0 +1,283 @@
+/*  Author: agent <agent@local>
+    Date: 19-October-2026
+    Description: A program to demonstrate batched payload processing in the child.
+                 ○ The kernels in payload_batch.c are first checked against the one at a time transform and timed
+                   on their own for growing batch sizes: one payload at a time, an array of payload_t structures,
+                   and a structure of arrays (with and without the cost of converting to and from it).
+                 ○ The parent then streams payloads to a child over the IPC channel in ../channel. The child takes
+                   whatever has arrived as one contiguous array with channel_recv_batch(), transforms it with the
+                   batch API and sends the whole batch back, so the per message cost of the transport is shared
+                   by every payload in a batch.
+
+    To Build:    gcc -O2 -o ipc_batch ipc_batch.c payload_batch.c ../channel/ipc_channel.c ../channel/crc32c.c -lrt
+    To Run:      ./ipc_batch [pipe|socket|mqueue|shm] [messages]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <stdbool.h>
+
+#include "payload_batch.h"
+#include "../channel/ipc_channel.h"
+
+#define MAX_BATCH       1024
+#define KERNEL_PAYLOADS (1U << 22)      //payloads pushed through every kernel per batch size
+
+void errExit(char *);
+void fill(payload_t *, unsigned int, unsigned int);
+void verify_kernels(void);
+void bench_kernels(void);
+unsigned int run(channel_transport_t, unsigned int, unsigned int);
+unsigned long long int now_ns(void);
+
+static payload_t input[MAX_BATCH], output[MAX_BATCH];
+
+int main(int argc, char *argv[])
+{
+  channel_transport_t transport = CHANNEL_SHARED_MEMORY;
+  unsigned int messages = 1000000, batch;
+
+  if(argc > 1 && channel_transport_parse(argv[1], &transport) == -1)
+  {
+    fprintf(stderr, "Usage: %s [pipe|socket|mqueue|shm] [messages]\n", argv[0]);
+    exit(EXIT_FAILURE);
+  }
+  if(argc > 2)
+    messages = (unsigned int) atoi(argv[2]);
+
+  printf("## KERNEL ## SSSE3: %s\n", payload_batch_simd_available() ? "available" : "not available, using portable C");
+
+  verify_kernels();
+  bench_kernels();
+
+  //stop once the channel cannot hold a whole batch (message queues), rather than repeat the largest one
+  for(batch = 1; batch <= 64; batch *= 4)
+  {
+    if(run(transport, messages, batch) < batch)
+      break;
+  }
+
+  exit(EXIT_SUCCESS);
+}
+
+//Strings of every length from empty to full, so truncation is exercised too.
+void fill(payload_t *data, unsigned int n, unsigned int seed)
+{
+  unsigned int i, len;
+
+  for(i = 0; i < n; i++)
+  {
+    bzero(&data[i], sizeof(payload_t));
+    len = (i + seed) % PAYLOAD_STRING_SIZE;
+    memset(data[i].string, 'a' + (i + seed) % 26, len);
+    data[i].led_state = (i + seed) & 1;
+  }
+}
+
+//Checks both batch layouts against payload_transform() before anything is timed.
+void verify_kernels(void)
+{
+  payload_t expected[MAX_BATCH];
+  payload_soa_t soa;
+  unsigned int i;
+
+  if(payload_soa_init(&soa, MAX_BATCH) == -1)
+    errExit("payload_soa_init");
+
+  fill(input, MAX_BATCH, 0);
+  memcpy(expected, input, sizeof(input));
+  for(i = 0; i < MAX_BATCH; i++)
+    payload_transform(&expected[i]);
+
+  memcpy(output, input, sizeof(input));
+  payload_transform_batch(output, MAX_BATCH);
+  for(i = 0; i < MAX_BATCH; i++)
+  {
+    if(strcmp(output[i].string, expected[i].string) || output[i].led_state != expected[i].led_state)
+    {
+      fprintf(stderr, "## VERIFY ## Array of structures kernel differs at %u: \"%s\".\n", i, output[i].string);
+      exit(EXIT_FAILURE);
+    }
+  }
+
+  payload_soa_load(&soa, input, MAX_BATCH);
+  payload_transform_soa(&soa);
+  payload_soa_store(&soa, output);
+  for(i = 0; i < MAX_BATCH; i++)
+  {
+    if(strcmp(output[i].string, expected[i].string) || output[i].led_state != expected[i].led_state)
+    {
+      fprintf(stderr, "## VERIFY ## Structure of arrays kernel differs at %u: \"%s\".\n", i, output[i].string);
+      exit(EXIT_FAILURE);
+    }
+  }
+
+  payload_soa_free(&soa);
+  printf("## VERIFY ## Batch kernels match the one at a time transform.\n");
+}
+
+void bench_kernels(void)
+{
+  payload_soa_t soa, fresh;
+  unsigned int batch, rounds, r, i;
+  unsigned long long int start, single_ns, aos_ns, soa_ns, soa_total_ns;
+
+  if(payload_soa_init(&soa, MAX_BATCH) == -1 || payload_soa_init(&fresh, MAX_BATCH) == -1)
+    errExit("payload_soa_init");
+
+  printf("## KERNEL ## %6s | %14s | %14s | %14s | %20s ##\n", "BATCH", "SINGLE ns/msg", "AOS ns/msg", "SOA ns/msg", "SOA+CONVERT ns/msg");
+
+  for(batch = 1; batch <= MAX_BATCH; batch *= 4)
+  {
+    rounds = KERNEL_PAYLOADS / batch;
+    fill(input, batch, 1);
+
+    //every round starts from fresh input so strings do not just saturate at 15 characters
+    start = now_ns();
+    for(r = 0; r < rounds; r++)
+    {
+      memcpy(output, input, batch * sizeof(payload_t));
+      for(i = 0; i < batch; i++)
+        payload_transform(&output[i]);
+    }
+    single_ns = now_ns() - start;
+
+    start = now_ns();
+    for(r = 0; r < rounds; r++)
+    {
+      memcpy(output, input, batch * sizeof(payload_t));
+      payload_transform_batch(output, batch);
+    }
+    aos_ns = now_ns() - start;
+
+    payload_soa_load(&soa, input, batch);
+    payload_soa_load(&fresh, input, batch);
+    start = now_ns();
+    for(r = 0; r < rounds; r++)
+    {
+      memcpy(soa.strings, fresh.strings, batch * PAYLOAD_STRING_SIZE);
+      memcpy(soa.led_states, fresh.led_states, batch);
+      payload_transform_soa(&soa);
+    }
+    soa_ns = now_ns() - start;
+
+    start = now_ns();
+    for(r = 0; r < rounds; r++)
+    {
+      payload_soa_load(&soa, input, batch);
+      payload_transform_soa(&soa);
+      payload_soa_store(&soa, output);
+    }
+    soa_total_ns = now_ns() - start;
+
+    printf("## KERNEL ## %6u | %14.2f | %14.2f | %14.2f | %20.2f ##\n", batch,
+           (double) single_ns / KERNEL_PAYLOADS, (double) aos_ns / KERNEL_PAYLOADS,
+           (double) soa_ns / KERNEL_PAYLOADS, (double) soa_total_ns / KERNEL_PAYLOADS);
+  }
+  payload_soa_free(&soa);
+  payload_soa_free(&fresh);
+}
+
+//Round trips messages through a child which transforms up to batch payloads per receive. Returns the batch used.
+unsigned int run(channel_transport_t transport, unsigned int messages, unsigned int batch)
+{
+  pid_t Child_Pid = 0;
+  channel_t ch;
+  payload_t expected;
+  unsigned int done = 0, chunk, i;
+  unsigned long long int start, elapsed;
+  int n;
+
+  if(channel_create(&ch, transport, sizeof(payload_t), batch) == -1)
+    errExit("channel_create");
+
+  //message queues may hold fewer payloads than a batch
+  if(batch > ch.depth)
+    batch = ch.depth;
+
+  switch (Child_Pid = fork())
+  {
+    case -1: /* fork() failed */
+      errExit("fork");
+      break;
+
+    case 0: /* Child of successful fork() comes here */
+      if(channel_attach(&ch, CHANNEL_CHILD) == -1)
+        errExit("child channel_attach");
+
+      while(done < messages)
+      {
+        if((n = channel_recv_batch(&ch, output, batch)) == -1)
+          errExit("receiving from parent to child");
+
+        payload_transform_batch(output, (unsigned int) n);
+
+        if(channel_send_batch(&ch, output, (unsigned int) n) == -1)
+          errExit("sending from child to parent");
+        done += (unsigned int) n;
+      }
+
+      channel_close(&ch);
+      _exit(EXIT_SUCCESS);
+
+    default: /* Parent comes here after successful fork() */
+      if(channel_attach(&ch, CHANNEL_PARENT) == -1)
+        errExit("parent channel_attach");
+
+      fill(input, batch, 2);
+
+      start = now_ns();
+      while(done < messages)
+      {
+        chunk = messages - done < batch ? messages - done : batch;
+        if(channel_send_batch(&ch, input, chunk) == -1)
+          errExit("sending from parent to child");
+
+        for(i = 0; i < chunk; i += (unsigned int) n)
+        {
+          if((n = channel_recv_batch(&ch, output + i, chunk - i)) == -1)
+            errExit("receiving from child to parent");
+        }
+
+        for(i = 0; i < chunk; i++)
+        {
+          expected = input[i];
+          payload_transform(&expected);
+          if(strcmp(output[i].string, expected.string) || output[i].led_state != expected.led_state)
+          {
+            fprintf(stderr, "## PARENT ## Reply %u is \"%s\", expected \"%s\".\n", done + i, output[i].string, expected.string);
+            exit(EXIT_FAILURE);
+          }
+        }
+        done += chunk;
+      }
+      elapsed = now_ns() - start;
+
+      waitpid(Child_Pid, NULL, 0);
+      channel_close(&ch);
+
+      printf("## PARENT ## %-6s | BATCH: %4u | %10.0f msgs/s ##\n", channel_transport_name(transport), batch, messages * 1e9 / elapsed);
+      break;
+  }
+  return batch;
+}
+
+unsigned long long int now_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (unsigned long long int) ts.tv_sec * 1000000000ULL + (unsigned long long int) ts.tv_nsec;
+}
+
+//Function to print the error to STDOUT and exit.
+void errExit(char *strError)
+{
+  perror(strError);
+  exit(EXIT_FAILURE);
+}
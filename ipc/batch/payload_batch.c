@@ -0,0 +1,195 @@
+/*  Author: agent <agent@local>
+    Date: 19-October-2026
+    Description: Scalar, array of structures and structure of arrays implementations of the payload transform
+                 declared in payload_batch.h.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define PAYLOAD_HAVE_SSSE3 1
+#include <tmmintrin.h>
+#endif
+
+#include "payload_batch.h"
+
+static const char suffix[PAYLOAD_STRING_SIZE] = " World";
+
+#ifdef PAYLOAD_HAVE_SSSE3
+/* Appends " World" to one 16 byte string held in a register:
+   - the first zero byte gives the length,
+   - the suffix is shifted up by the length with a byte shuffle (negative indices select zero),
+   - bytes below the length are kept from the string, the rest come from the shifted suffix,
+   - the last byte is cleared so an overlong result is truncated and still terminated. */
+__attribute__((target("ssse3")))
+static inline __m128i append_suffix(__m128i str)
+{
+  const __m128i lanes = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+  const __m128i last_lane = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 0);
+  const __m128i suffix_vec = _mm_loadu_si128((const __m128i *) suffix);
+  int zeros = _mm_movemask_epi8(_mm_cmpeq_epi8(str, _mm_setzero_si128()));
+  __m128i len = _mm_set1_epi8((char) (zeros ? __builtin_ctz(zeros) : PAYLOAD_STRING_SIZE));
+  __m128i shifted = _mm_shuffle_epi8(suffix_vec, _mm_sub_epi8(lanes, len));
+  __m128i keep = _mm_cmplt_epi8(lanes, len);
+
+  return _mm_and_si128(_mm_or_si128(_mm_and_si128(keep, str), _mm_andnot_si128(keep, shifted)), last_lane);
+}
+
+__attribute__((target("ssse3")))
+static void transform_batch_ssse3(payload_t *data, unsigned int n)
+{
+  unsigned int i;
+
+  for(i = 0; i < n; i++)
+  {
+    _mm_storeu_si128((__m128i *) data[i].string, append_suffix(_mm_loadu_si128((const __m128i *) data[i].string)));
+    data[i].led_state = !data[i].led_state;
+  }
+}
+
+__attribute__((target("ssse3")))
+static void transform_soa_ssse3(payload_soa_t *soa)
+{
+  const __m128i ones = _mm_set1_epi8(1);
+  unsigned int i;
+
+  for(i = 0; i < soa->count; i++)
+    _mm_store_si128((__m128i *) soa->strings[i], append_suffix(_mm_load_si128((const __m128i *) soa->strings[i])));
+
+  //bool is 0 or 1, so a flip is an XOR with 1
+  for(i = 0; i + PAYLOAD_STRING_SIZE <= soa->count; i += PAYLOAD_STRING_SIZE)
+    _mm_store_si128((__m128i *) (soa->led_states + i), _mm_xor_si128(_mm_load_si128((const __m128i *) (soa->led_states + i)), ones));
+
+  for(; i < soa->count; i++)
+    soa->led_states[i] = !soa->led_states[i];
+}
+#endif
+
+bool payload_batch_simd_available(void)
+{
+#ifdef PAYLOAD_HAVE_SSSE3
+  return __builtin_cpu_supports("ssse3");
+#else
+  return false;
+#endif
+}
+
+//Decided on the first call, so the binary does not need to be built with -mssse3.
+static bool use_simd(void)
+{
+  static int simd = -1;
+
+  if(simd == -1)
+    simd = payload_batch_simd_available();
+  return simd;
+}
+
+//Portable equivalent of append_suffix(), used for single payloads and on processors without SSSE3.
+static inline void append_suffix_scalar(char *string)
+{
+  size_t len = strnlen(string, PAYLOAD_STRING_SIZE);
+
+  if(len == PAYLOAD_STRING_SIZE)
+    len = PAYLOAD_STRING_SIZE - 1;
+  string[len] = '\0';
+  strncat(string, suffix, PAYLOAD_STRING_SIZE - len - 1);
+}
+
+//The transform the standalone demos apply, one payload at a time.
+void payload_transform(payload_t *data)
+{
+  append_suffix_scalar(data->string);
+  data->led_state = !data->led_state;
+}
+
+//Transforms n payload_t structures in place, as they arrive off the channel.
+void payload_transform_batch(payload_t *data, unsigned int n)
+{
+  unsigned int i;
+
+#ifdef PAYLOAD_HAVE_SSSE3
+  if(use_simd())
+  {
+    transform_batch_ssse3(data, n);
+    return;
+  }
+#endif
+
+  for(i = 0; i < n; i++)
+  {
+    append_suffix_scalar(data[i].string);
+    data[i].led_state = !data[i].led_state;
+  }
+}
+
+int payload_soa_init(payload_soa_t *soa, unsigned int capacity)
+{
+  soa->count = 0;
+  soa->capacity = capacity;
+  soa->strings = aligned_alloc(PAYLOAD_STRING_SIZE, (size_t) capacity * PAYLOAD_STRING_SIZE);
+  soa->led_states = aligned_alloc(PAYLOAD_STRING_SIZE, (capacity + PAYLOAD_STRING_SIZE - 1) & ~(PAYLOAD_STRING_SIZE - 1U));
+
+  if(soa->strings == NULL || soa->led_states == NULL)
+  {
+    payload_soa_free(soa);
+    return -1;
+  }
+  return 0;
+}
+
+void payload_soa_free(payload_soa_t *soa)
+{
+  free(soa->strings);
+  free(soa->led_states);
+  soa->strings = NULL;
+  soa->led_states = NULL;
+  soa->count = soa->capacity = 0;
+}
+
+//Splits up to capacity payloads into the structure of arrays.
+void payload_soa_load(payload_soa_t *soa, const payload_t *data, unsigned int n)
+{
+  unsigned int i;
+
+  if(n > soa->capacity)
+    n = soa->capacity;
+
+  for(i = 0; i < n; i++)
+  {
+    memcpy(soa->strings[i], data[i].string, PAYLOAD_STRING_SIZE);
+    soa->led_states[i] = data[i].led_state;
+  }
+  soa->count = n;
+}
+
+void payload_soa_store(const payload_soa_t *soa, payload_t *data)
+{
+  unsigned int i;
+
+  for(i = 0; i < soa->count; i++)
+  {
+    memcpy(data[i].string, soa->strings[i], PAYLOAD_STRING_SIZE);
+    data[i].led_state = soa->led_states[i];
+  }
+}
+
+//Transforms every payload in the structure of arrays. With SSSE3 the LED states are flipped 16 at a time.
+void payload_transform_soa(payload_soa_t *soa)
+{
+  unsigned int i;
+
+#ifdef PAYLOAD_HAVE_SSSE3
+  if(use_simd())
+  {
+    transform_soa_ssse3(soa);
+    return;
+  }
+#endif
+
+  for(i = 0; i < soa->count; i++)
+  {
+    append_suffix_scalar(soa->strings[i]);
+    soa->led_states[i] = !soa->led_states[i];
+  }
+}
@@ -0,0 +1,48 @@
+/*  Author: agent <agent@local>
+    Date: 19-October-2026
+    Description: Batch API for the child's payload transform (append " World" to the string, flip the LED state).
+                 A worker is handed a contiguous array of payloads, either as the array of payload_t structures
+                 that arrives off the channel or split into a structure of arrays, where all strings are packed
+                 in 16 byte aligned rows and all LED states sit next to each other.
+
+                 Each string is exactly one 128 bit register, so the append is done without strlen() or strcat():
+                 the terminator is found with a byte compare, " World" is shifted into place with a byte shuffle
+                 and blended over the string. The kernels use SSSE3 when the processor has it, which is checked
+                 once at run time so no -mssse3 is needed, and fall back to portable C otherwise. Strings are
+                 truncated to 15 characters the same way strncat() would truncate them.
+*/
+
+#ifndef PAYLOAD_BATCH_H
+#define PAYLOAD_BATCH_H
+
+#include <stdbool.h>
+
+#define PAYLOAD_STRING_SIZE 16
+
+//Structure of the data which is communicated between the parent and the child.
+typedef struct payload
+{
+  char string[PAYLOAD_STRING_SIZE];
+  bool led_state;
+} payload_t;
+
+//The same payloads as a structure of arrays.
+typedef struct payload_soa
+{
+  char (*strings)[PAYLOAD_STRING_SIZE];
+  bool *led_states;
+  unsigned int count;
+  unsigned int capacity;
+} payload_soa_t;
+
+void payload_transform(payload_t *);
+void payload_transform_batch(payload_t *, unsigned int);
+
+int payload_soa_init(payload_soa_t *, unsigned int);
+void payload_soa_free(payload_soa_t *);
+void payload_soa_load(payload_soa_t *, const payload_t *, unsigned int);
+void payload_soa_store(const payload_soa_t *, payload_t *);
+void payload_transform_soa(payload_soa_t *);
+bool payload_batch_simd_available(void);
+
+#endif
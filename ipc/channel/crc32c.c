@@ -0,0 +1,259 @@
+/*  Author: agent <agent@local>
+    Date: 19-October-2026
+    Description: Hardware and table driven CRC32C implementations declared in crc32c.h.
+*/
+
+#include <string.h>
+
+#include "crc32c.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define CRC32C_HAVE_SSE42 1
+#include <nmmintrin.h>
+#endif
+
+#define CRC32C_POLY 0x82F63B78U     //Castagnoli polynomial, bit reversed
+#define CRC32C_LONG  2048           //bytes per stream in a round over a long buffer
+#define CRC32C_SHORT 64             //bytes per stream in a round over a short one, e.g. a channel frame
+
+static unsigned int table[256];
+static bool table_ready;
+
+static void build_table(void)
+{
+  unsigned int i, j, crc;
+
+  for(i = 0; i < 256; i++)
+  {
+    crc = i;
+    for(j = 0; j < 8; j++)
+      crc = (crc >> 1) ^ (CRC32C_POLY & (0U - (crc & 1)));
+    table[i] = crc;
+  }
+  table_ready = true;
+}
+
+//Continues a checksum over len more bytes. Start a new checksum with crc = 0.
+unsigned int crc32c_software(unsigned int crc, const void *data, size_t len)
+{
+  const unsigned char *p = (const unsigned char *) data;
+
+  if(!table_ready)
+    build_table();
+
+  crc = ~crc;
+  while(len--)
+    crc = (crc >> 8) ^ table[(crc ^ *p++) & 0xFF];
+  return ~crc;
+}
+
+#ifdef CRC32C_HAVE_SSE42
+/* The crc32 instruction has a latency of three cycles but can start one every cycle, so a single dependent
+   chain of them runs at a third of the speed the processor allows. Buffers long enough are therefore cut into
+   three blocks whose CRCs are computed side by side, and joined afterwards by shifting the first two over the
+   length of the blocks that follow them: shift(crc, n) is the CRC register after n zero bytes, which is linear
+   in crc, so it is looked up one byte of crc at a time in tables built once per block length. */
+static unsigned int shift_long[4][256], shift_short[4][256];
+static bool shift_ready;
+
+__attribute__((target("sse4.2")))
+static void build_shift_table(unsigned int table[4][256], size_t len)
+{
+  unsigned long long int c;
+  unsigned int basis[32], i, b;
+  size_t n;
+
+  for(i = 0; i < 32; i++)
+  {
+    c = 1U << i;
+    for(n = 0; n < len; n += 8)
+      c = _mm_crc32_u64(c, 0);
+    basis[i] = (unsigned int) c;
+  }
+
+  for(i = 0; i < 4; i++)
+  {
+    for(b = 0; b < 256; b++)
+    {
+      table[i][b] = 0;
+      for(n = 0; n < 8; n++)
+      {
+        if(b & (1U << n))
+          table[i][b] ^= basis[i * 8 + n];
+      }
+    }
+  }
+}
+
+static unsigned int shift(unsigned int table[4][256], unsigned int crc)
+{
+  return table[0][crc & 0xFF] ^ table[1][(crc >> 8) & 0xFF] ^ table[2][(crc >> 16) & 0xFF] ^ table[3][crc >> 24];
+}
+
+/* The loops below optionally store every word they load at dst as well, so that a copy and its checksum take
+   one pass over the data. They are always inlined into the two callers, where dst is either always NULL or
+   never, so neither pays for the test. */
+__attribute__((target("sse4.2"), always_inline))
+static inline unsigned long long int crc32c_sse42_rounds(unsigned long long int c, unsigned char **dst, const unsigned char **data, size_t *len, size_t block, unsigned int table[4][256])
+{
+  const unsigned char *p = *data;
+  unsigned char *d = *dst;
+  unsigned long long int c1, c2, w0, w1, w2;
+  size_t i;
+
+  while(*len >= 3 * block)
+  {
+    c1 = c2 = 0;
+    for(i = 0; i < block; i += 8)
+    {
+      memcpy(&w0, p + i, 8);
+      memcpy(&w1, p + block + i, 8);
+      memcpy(&w2, p + 2 * block + i, 8);
+      c = _mm_crc32_u64(c, w0);
+      c1 = _mm_crc32_u64(c1, w1);
+      c2 = _mm_crc32_u64(c2, w2);
+      if(d)
+      {
+        memcpy(d + i, &w0, 8);
+        memcpy(d + block + i, &w1, 8);
+        memcpy(d + 2 * block + i, &w2, 8);
+      }
+    }
+    c = shift(table, shift(table, (unsigned int) c) ^ (unsigned int) c1) ^ (unsigned int) c2;
+    p += 3 * block;
+    if(d)
+      d += 3 * block;
+    *len -= 3 * block;
+  }
+
+  *data = p;
+  *dst = d;
+  return c;
+}
+
+__attribute__((target("sse4.2"), always_inline))
+static inline unsigned int crc32c_sse42_body(unsigned int crc, unsigned char *d, const unsigned char *p, size_t len)
+{
+  unsigned long long int c = ~crc, word;
+  unsigned int half;
+  unsigned short quarter;
+
+  if(len >= 3 * CRC32C_SHORT)
+  {
+    if(!shift_ready)
+    {
+      build_shift_table(shift_long, CRC32C_LONG);
+      build_shift_table(shift_short, CRC32C_SHORT);
+      shift_ready = true;
+    }
+    c = crc32c_sse42_rounds(c, &d, &p, &len, CRC32C_LONG, shift_long);
+    c = crc32c_sse42_rounds(c, &d, &p, &len, CRC32C_SHORT, shift_short);
+  }
+
+  for(; len >= 8; len -= 8, p += 8)
+  {
+    memcpy(&word, p, sizeof(word));
+    c = _mm_crc32_u64(c, word);
+    if(d)
+    {
+      memcpy(d, &word, sizeof(word));
+      d += 8;
+    }
+  }
+  if(len >= 4)
+  {
+    memcpy(&half, p, sizeof(half));
+    c = _mm_crc32_u32((unsigned int) c, half);
+    if(d)
+    {
+      memcpy(d, &half, sizeof(half));
+      d += 4;
+    }
+    p += 4;
+    len -= 4;
+  }
+  if(len >= 2)
+  {
+    memcpy(&quarter, p, sizeof(quarter));
+    c = _mm_crc32_u16((unsigned int) c, quarter);
+    if(d)
+    {
+      memcpy(d, &quarter, sizeof(quarter));
+      d += 2;
+    }
+    p += 2;
+    len -= 2;
+  }
+  if(len)
+  {
+    c = _mm_crc32_u8((unsigned int) c, *p);
+    if(d)
+      *d = *p;
+  }
+
+  return ~(unsigned int) c;
+}
+
+__attribute__((target("sse4.2")))
+static unsigned int crc32c_sse42(unsigned int crc, const void *data, size_t len)
+{
+  return crc32c_sse42_body(crc, NULL, (const unsigned char *) data, len);
+}
+
+__attribute__((target("sse4.2")))
+static unsigned int crc32c_sse42_copy(unsigned int crc, void *dst, const void *src, size_t len)
+{
+  return crc32c_sse42_body(crc, (unsigned char *) dst, (const unsigned char *) src, len);
+}
+#endif
+
+bool crc32c_hardware_available(void)
+{
+#ifdef CRC32C_HAVE_SSE42
+  return __builtin_cpu_supports("sse4.2");
+#else
+  return false;
+#endif
+}
+
+#ifdef CRC32C_HAVE_SSE42
+static bool use_hardware(void)
+{
+  static int hardware = -1;     //decided on the first call
+
+  if(hardware == -1)
+    hardware = crc32c_hardware_available();
+  return hardware;
+}
+#endif
+
+unsigned int crc32c(unsigned int crc, const void *data, size_t len)
+{
+#ifdef CRC32C_HAVE_SSE42
+  if(use_hardware())
+    return crc32c_sse42(crc, data, len);
+#endif
+  return crc32c_software(crc, data, len);
+}
+
+unsigned int crc32c_copy(unsigned int crc, void *dst, const void *src, size_t len)
+{
+  const unsigned char *p = (const unsigned char *) src;
+  unsigned char *d = (unsigned char *) dst;
+
+#ifdef CRC32C_HAVE_SSE42
+  if(use_hardware())
+    return crc32c_sse42_copy(crc, dst, src, len);
+#endif
+
+  if(!table_ready)
+    build_table();
+
+  crc = ~crc;
+  while(len--)
+  {
+    crc = (crc >> 8) ^ table[(crc ^ *p) & 0xFF];
+    *d++ = *p++;
+  }
+  return ~crc;
+}
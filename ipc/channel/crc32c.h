@@ -0,0 +1,23 @@
+/*  Author: agent <agent@local>
+    Date: 19-October-2026
+    Description: CRC32C (Castagnoli) checksums for channel frames. On x86 processors with SSE4.2 the checksum
+                 is computed with the crc32 instruction, eight bytes at a time; everywhere else a table driven
+                 implementation gives the same result. The choice is made once, at run time, so the binary does
+                 not need to be built with -msse4.2.
+
+                 crc32c_copy() also copies the bytes it checksums, in the same pass, so a frame can be checked
+                 while it is moved in or out of a transport instead of being read a second time for the check.
+*/
+
+#ifndef CRC32C_H
+#define CRC32C_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+unsigned int crc32c(unsigned int, const void *, size_t);
+unsigned int crc32c_software(unsigned int, const void *, size_t);
+unsigned int crc32c_copy(unsigned int, void *, const void *, size_t);
+bool crc32c_hardware_available(void);
+
+#endif
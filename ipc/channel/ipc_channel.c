@@ -0,0 +1,810 @@
+/*  Author: agent <agent@local>
+    Date: 19-October-2026
+    Description: Implementation of the parent/child channel declared in ipc_channel.h.
+                 ○ Pipes:          one pipe per direction, the unused ends are closed on attach.
+                 ○ Sockets:        a SOCK_SEQPACKET socketpair, so every frame keeps its boundaries.
+                 ○ Message queues: one named queue per direction (the message_queues demo shares one).
+                 ○ Shared memory:  one lock free single producer / single consumer ring per direction in an
+                                   anonymous shared mapping which the child inherits across fork().
+
+                 Every transport moves whole wire frames (header followed by the caller's frame), and moves as
+                 many of them per call as it can: one write() or sendmmsg() per batch on pipes and sockets, one
+                 index update per batch on the shared memory rings.
+
+                 Shared memory frames are built straight into their ring slots and taken straight out of them,
+                 the other transports stage whole batches in a transmit and a receive buffer. With checksums on,
+                 the CRC32C is computed in the same pass that copies the caller's frame into the wire frame, and
+                 checked in the pass that copies it out again, so the check covers the transport and the copies
+                 on both sides of it without reading any frame twice.
+*/
+
+#define _GNU_SOURCE     //sendmmsg(), recvmmsg()
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <string.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sched.h>
+#include <time.h>
+#include <errno.h>
+
+#include "ipc_channel.h"
+#include "crc32c.h"
+
+#define CHANNEL_SPIN_LIMIT  128     //busy polls of a shared memory ring before yielding the CPU
+#define CHANNEL_MAX_MMSG    64      //frames per sendmmsg()/recvmmsg() call
+
+static const char *transport_names[] = { "pipe", "socket", "mqueue", "shm" };
+
+static unsigned long long int now_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (unsigned long long int) ts.tv_sec * 1000000000ULL + (unsigned long long int) ts.tv_nsec;
+}
+
+//Largest queue an unprivileged process may create, from /proc/sys/fs/mqueue/msg_max.
+static unsigned int mq_max_depth(void)
+{
+  FILE *f;
+  unsigned int max = 10;
+
+  if((f = fopen("/proc/sys/fs/mqueue/msg_max", "r")) != NULL)
+  {
+    if(fscanf(f, "%u", &max) != 1)
+      max = 10;
+    fclose(f);
+  }
+  return max;
+}
+
+static void ring_wait(unsigned int *spins)
+{
+  if(++(*spins) > CHANNEL_SPIN_LIMIT)
+    sched_yield();
+}
+
+//Loops over short reads so a frame is only ever returned whole. A closed peer is reported as EPIPE.
+static int read_full(int fd, void *buf, size_t len)
+{
+  ssize_t n;
+  size_t done = 0;
+
+  while(done < len)
+  {
+    n = read(fd, (char *) buf + done, len - done);
+    if(n == -1)
+    {
+      if(errno == EINTR)
+        continue;
+      return -1;
+    }
+    if(n == 0)
+    {
+      errno = EPIPE;
+      return -1;
+    }
+    done += (size_t) n;
+  }
+  return 0;
+}
+
+static int write_full(int fd, const void *buf, size_t len)
+{
+  ssize_t n;
+  size_t done = 0;
+
+  while(done < len)
+  {
+    n = write(fd, (const char *) buf + done, len - done);
+    if(n == -1)
+    {
+      if(errno == EINTR)
+        continue;
+      return -1;
+    }
+    done += (size_t) n;
+  }
+  return 0;
+}
+
+/* Returns how many of n wire frames can be laid out for sending right now, at most the channel depth. On a
+   shared memory ring this waits until at least one slot is free, since the frames are built in the slots. */
+static unsigned int wire_reserve(channel_t *ch, unsigned int n)
+{
+  channel_ring_t *ring;
+  unsigned long tail, room;
+  unsigned int spins = 0;
+  unsigned long long int wait_start;
+
+  if(n > ch->depth)
+    n = ch->depth;
+  if(ch->transport != CHANNEL_SHARED_MEMORY)
+    return n;
+
+  ring = ch->tx_ring;
+  tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+  room = ch->depth - (tail - atomic_load_explicit(&ring->head, memory_order_acquire));
+  if(room == 0)
+  {
+    wait_start = now_ns();
+    do
+    {
+      ring_wait(&spins);
+      room = ch->depth - (tail - atomic_load_explicit(&ring->head, memory_order_acquire));
+    } while(room == 0);
+    ch->stats.blocked_ns += now_ns() - wait_start;
+  }
+  return n < room ? n : (unsigned int) room;
+}
+
+//Where the i-th reserved frame is laid out: in the transmit buffer, or straight in its ring slot.
+static unsigned char *wire_tx_frame(channel_t *ch, unsigned int i)
+{
+  unsigned long tail;
+
+  if(ch->transport == CHANNEL_SHARED_MEMORY)
+  {
+    tail = atomic_load_explicit(&ch->tx_ring->tail, memory_order_relaxed);
+    return ch->tx_ring->slots + ((tail + i) & (ch->depth - 1)) * ch->wire_size;
+  }
+  return ch->tx_buf + i * ch->wire_size;
+}
+
+//Sends the first n reserved frames, blocking until all of them are handed to the transport.
+static int wire_write(channel_t *ch, unsigned int n)
+{
+  struct mmsghdr msgs[CHANNEL_MAX_MMSG];
+  struct iovec iov[CHANNEL_MAX_MMSG];
+  const unsigned char *buf = ch->tx_buf;
+  unsigned int i, chunk;
+  unsigned long long int start = now_ns();
+  int sent;
+
+  switch(ch->transport)
+  {
+    case CHANNEL_PIPE:
+      if(write_full(ch->tx_fd, buf, n * ch->wire_size) == -1)
+        return -1;
+      break;
+
+    case CHANNEL_SOCKET:
+      while(n > 0)
+      {
+        chunk = n < CHANNEL_MAX_MMSG ? n : CHANNEL_MAX_MMSG;
+        bzero(msgs, chunk * sizeof(struct mmsghdr));
+        for(i = 0; i < chunk; i++)
+        {
+          iov[i].iov_base = (void *) (buf + i * ch->wire_size);
+          iov[i].iov_len = ch->wire_size;
+          msgs[i].msg_hdr.msg_iov = &iov[i];
+          msgs[i].msg_hdr.msg_iovlen = 1;
+        }
+        if((sent = sendmmsg(ch->tx_fd, msgs, chunk, MSG_NOSIGNAL)) == -1)
+        {
+          if(errno == EINTR)
+            continue;
+          return -1;
+        }
+        buf += (unsigned int) sent * ch->wire_size;
+        n -= (unsigned int) sent;
+      }
+      break;
+
+    case CHANNEL_MESSAGE_QUEUE:
+      for(i = 0; i < n; i++)
+      {
+        while(mq_send(ch->tx_queue, (const char *) buf + i * ch->wire_size, ch->wire_size, 0) == -1)
+        {
+          if(errno != EINTR)
+            return -1;
+        }
+      }
+      break;
+
+    case CHANNEL_SHARED_MEMORY:
+      //the frames are already in their slots, publishing them is one index update
+      atomic_store_explicit(&ch->tx_ring->tail, atomic_load_explicit(&ch->tx_ring->tail, memory_order_relaxed) + n, memory_order_release);
+      break;
+
+    default:
+      errno = EINVAL;
+      return -1;
+  }
+
+  ch->stats.send_ns += now_ns() - start;
+  return 0;
+}
+
+/* Blocks until at least one wire frame is available and returns how many, up to max, can be taken. Pipes,
+   sockets and message queues read them into the receive buffer; on a shared memory ring they stay in their
+   slots until wire_release(). */
+static int wire_read(channel_t *ch, unsigned int max)
+{
+  struct mmsghdr msgs[CHANNEL_MAX_MMSG];
+  struct iovec iov[CHANNEL_MAX_MMSG];
+  struct mq_attr attr;
+  unsigned char *buf = ch->rx_buf;
+  channel_ring_t *ring;
+  unsigned long head, avail;
+  unsigned int i, spins = 0;
+  ssize_t n;
+  int received;
+
+  switch(ch->transport)
+  {
+    case CHANNEL_PIPE:
+      while((n = read(ch->rx_fd, buf, max * ch->wire_size)) == -1)
+      {
+        if(errno != EINTR)
+          return -1;
+      }
+      if(n == 0)
+      {
+        errno = EPIPE;
+        return -1;
+      }
+      //finish a frame which was only partly in the pipe
+      if(n % ch->wire_size)
+      {
+        if(read_full(ch->rx_fd, buf + n, ch->wire_size - n % ch->wire_size) == -1)
+          return -1;
+        n += ch->wire_size - n % ch->wire_size;
+      }
+      return (int) (n / ch->wire_size);
+
+    case CHANNEL_SOCKET:
+      if(max > CHANNEL_MAX_MMSG)
+        max = CHANNEL_MAX_MMSG;
+      bzero(msgs, max * sizeof(struct mmsghdr));
+      for(i = 0; i < max; i++)
+      {
+        iov[i].iov_base = buf + i * ch->wire_size;
+        iov[i].iov_len = ch->wire_size;
+        msgs[i].msg_hdr.msg_iov = &iov[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+      }
+      /* A peer which closes with frames of ours unread (typically a last credit grant) makes the next read fail
+         with ECONNRESET ahead of the frames it sent before closing. The error is only reported once, so reading
+         again returns those frames and then end of file. */
+      while((received = recvmmsg(ch->rx_fd, msgs, max, MSG_WAITFORONE, NULL)) == -1)
+      {
+        if(errno != EINTR && errno != ECONNRESET)
+          return -1;
+      }
+      if(received == 0 || msgs[0].msg_len == 0)
+      {
+        errno = EPIPE;
+        return -1;
+      }
+      return received;
+
+    case CHANNEL_MESSAGE_QUEUE:
+      while(mq_receive(ch->rx_queue, (char *) buf, ch->wire_size, NULL) == -1)
+      {
+        if(errno != EINTR)
+          return -1;
+      }
+      received = 1;
+
+      //take whatever else is already queued, without blocking
+      if(max > 1 && mq_getattr(ch->rx_queue, &attr) == 0)
+      {
+        for(i = 0; i < (unsigned long) attr.mq_curmsgs && received < (int) max; i++, received++)
+        {
+          if(mq_receive(ch->rx_queue, (char *) buf + received * ch->wire_size, ch->wire_size, NULL) == -1)
+            return -1;
+        }
+      }
+      return received;
+
+    case CHANNEL_SHARED_MEMORY:
+      ring = ch->rx_ring;
+      head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+      while((avail = atomic_load_explicit(&ring->tail, memory_order_acquire) - head) == 0)
+        ring_wait(&spins);
+      return (int) (avail < max ? avail : max);
+  }
+  errno = EINVAL;
+  return -1;
+}
+
+//Where the i-th frame returned by wire_read() is: in the receive buffer, or still in its ring slot.
+static const unsigned char *wire_rx_frame(channel_t *ch, unsigned int i)
+{
+  unsigned long head;
+
+  if(ch->transport == CHANNEL_SHARED_MEMORY)
+  {
+    head = atomic_load_explicit(&ch->rx_ring->head, memory_order_relaxed);
+    return ch->rx_ring->slots + ((head + i) & (ch->depth - 1)) * ch->wire_size;
+  }
+  return ch->rx_buf + i * ch->wire_size;
+}
+
+//Hands the slots of n frames returned by wire_read() back to a shared memory ring's producer.
+static void wire_release(channel_t *ch, unsigned int n)
+{
+  if(ch->transport == CHANNEL_SHARED_MEMORY)
+    atomic_store_explicit(&ch->rx_ring->head, atomic_load_explicit(&ch->rx_ring->head, memory_order_relaxed) + n, memory_order_release);
+}
+
+/* Lays out a wire frame carrying payload, or zeroes for a credit frame. With checksums on, the CRC32C is
+   computed while the payload is copied in, so sealing a frame costs no extra pass over it. The checksum leads
+   the header, so everything after it is one contiguous run. */
+static void build_frame(channel_t *ch, unsigned char *wire, unsigned short type, unsigned int consumed, const unsigned char *payload)
+{
+  channel_header_t header;
+  unsigned char *dst = wire + sizeof(header);
+
+  header.checksum = 0;
+  header.type = type;
+  header.flags = ch->checksum ? CHANNEL_FLAG_CHECKSUM : 0;
+  header.consumed = consumed;
+
+  if(!ch->checksum)
+  {
+    if(payload)
+      memcpy(dst, payload, ch->frame_size);
+    else
+      bzero(dst, ch->frame_size);
+  }
+  else
+  {
+    header.checksum = crc32c(0, (const unsigned char *) &header + offsetof(channel_header_t, type), sizeof(header) - offsetof(channel_header_t, type));
+    if(payload)
+      header.checksum = crc32c_copy(header.checksum, dst, payload, ch->frame_size);
+    else
+    {
+      bzero(dst, ch->frame_size);
+      header.checksum = crc32c(header.checksum, dst, ch->frame_size);
+    }
+  }
+
+  memcpy(wire, &header, sizeof(header));
+}
+
+//Counts n of the peer's frames as consumed, i.e. owed back to the peer as credits.
+static void consume(channel_t *ch, unsigned int n)
+{
+  ch->consumed += n;
+  ch->consumed_total += n;
+}
+
+/* A grant carries the total number of frames the peer has consumed, so what this side may still send is the
+   window less the frames it has sent since. Unsigned arithmetic keeps that right when the totals wrap. */
+static void take_credits(channel_t *ch, unsigned int peer_consumed)
+{
+  ch->credits = ch->credit_window - (ch->sent - peer_consumed);
+}
+
+/* Takes one received wire frame: a credit frame updates this side's credits, a data frame's payload is copied
+   to dst. Returns 1 when a data frame was delivered to dst and 0 otherwise. dst may be NULL when there is no
+   room for a data frame, which then fails with EOVERFLOW.
+
+   With checksums on, every frame must carry CHANNEL_FLAG_CHECKSUM and a matching CRC32C, which is computed
+   while the payload is copied out. Requiring the flag matters: it is covered by the checksum, so a bit flip
+   clearing it, or an all zero torn slot, would otherwise skip the check. A frame which fails is counted and,
+   unless it claims to be a credit frame, treated as consumed so that the sender still gets its credit back.
+   A corrupted credit frame is simply dropped: grants carry running totals, so the next one makes up for it. */
+static int take_frame(channel_t *ch, const unsigned char *wire, unsigned char *dst)
+{
+  channel_header_t header;
+  unsigned int crc;
+
+  memcpy(&header, wire, sizeof(header));
+
+  if(ch->checksum)
+  {
+    crc = crc32c(0, wire + offsetof(channel_header_t, type), sizeof(header) - offsetof(channel_header_t, type));
+    if(header.type == CHANNEL_FRAME_CREDIT || dst == NULL)
+      crc = crc32c(crc, wire + sizeof(header), ch->frame_size);
+    else
+      crc = crc32c_copy(crc, dst, wire + sizeof(header), ch->frame_size);
+
+    if(!(header.flags & CHANNEL_FLAG_CHECKSUM) || crc != header.checksum)
+    {
+      ch->stats.checksum_errors++;
+      if(ch->credit_window && header.type != CHANNEL_FRAME_CREDIT)
+        consume(ch, 1);
+      return 0;
+    }
+    ch->stats.checksums_verified++;
+  }
+
+  if(header.type == CHANNEL_FRAME_CREDIT)
+  {
+    take_credits(ch, header.consumed);
+    return 0;
+  }
+  if(dst == NULL)
+  {
+    errno = EOVERFLOW;
+    return -1;
+  }
+  if(!ch->checksum)
+    memcpy(dst, wire + sizeof(header), ch->frame_size);
+  return 1;
+}
+
+//Grants the peer credits for every frame consumed since the last grant.
+static int send_credits(channel_t *ch)
+{
+  wire_reserve(ch, 1);
+  build_frame(ch, wire_tx_frame(ch, 0), CHANNEL_FRAME_CREDIT, ch->consumed_total, NULL);
+
+  //the last grant of an exchange can race with the peer closing its end, and a peer which has gone needs no credits
+  if(wire_write(ch, 1) == -1)
+    return errno == EPIPE ? 0 : -1;
+
+  ch->stats.credits_granted += ch->consumed;
+  ch->consumed = 0;
+  return 0;
+}
+
+/* Reads frames until the peer grants more credits. Data frames read on the way are kept in the stash for
+   channel_recv(), which credits them once it delivers them. The peer cannot have more than a window of frames
+   in flight, so the stash holds one window and is never read into beyond its room: with the stash full only a
+   credit frame may come next, and a data frame instead means the peer ignored its credits (EOVERFLOW).
+
+   Frames consumed but not yet credited are granted before waiting, so two sides sending to each other never
+   both wait on grants they are each holding back. They can then each get one window ahead of the other's
+   channel_recv() calls, and no further. */
+static int wait_for_credits(channel_t *ch)
+{
+  unsigned int room;
+  unsigned long long int start = now_ns();
+  int n, i, taken;
+
+  ch->stats.credit_stalls++;
+
+  if(ch->consumed > 0 && send_credits(ch) == -1)
+    return -1;
+
+  while(ch->credits == 0)
+  {
+    room = ch->credit_window - ch->stash_count;
+    if((n = wire_read(ch, room ? room : 1)) == -1)
+      return -1;
+
+    for(i = 0; i < n; i++)
+    {
+      taken = take_frame(ch, wire_rx_frame(ch, i), ch->stash_count < ch->credit_window ?
+                         ch->stash + ((ch->stash_head + ch->stash_count) % ch->credit_window) * ch->frame_size : NULL);
+      if(taken == -1)
+      {
+        wire_release(ch, n);
+        return -1;
+      }
+      ch->stash_count += (unsigned int) taken;
+    }
+    wire_release(ch, n);
+
+    //frames dropped on bad checksums are credited at once, nothing else will deliver them
+    if(ch->consumed > 0 && send_credits(ch) == -1)
+      return -1;
+  }
+
+  ch->stats.blocked_ns += now_ns() - start;
+  return 0;
+}
+
+int channel_create(channel_t *ch, channel_transport_t transport, size_t frame_size, unsigned int depth)
+{
+  struct mq_attr attr;
+  unsigned int i, slots;
+  void *map_addr;
+
+  bzero(ch, sizeof(channel_t));
+  ch->transport = transport;
+  ch->frame_size = frame_size;
+  ch->wire_size = sizeof(channel_header_t) + frame_size;
+  ch->depth = depth ? depth : 1;
+  ch->tx_fd = ch->rx_fd = -1;
+  ch->tx_queue = ch->rx_queue = (mqd_t) -1;
+  ch->queues[0] = ch->queues[1] = (mqd_t) -1;
+
+  switch(transport)
+  {
+    case CHANNEL_PIPE:
+      if(pipe(ch->pipes[0]) == -1)
+        return -1;
+      if(pipe(ch->pipes[1]) == -1)
+        return -1;
+      break;
+
+    case CHANNEL_SOCKET:
+      if(socketpair(AF_UNIX, SOCK_SEQPACKET, 0, ch->sockets) == -1)
+        return -1;
+      break;
+
+    case CHANNEL_MESSAGE_QUEUE:
+      if(ch->depth > mq_max_depth())
+        ch->depth = mq_max_depth();
+
+      bzero(&attr, sizeof(attr));
+      attr.mq_maxmsg = ch->depth;
+      attr.mq_msgsize = (long) ch->wire_size;
+
+      for(i = 0; i < 2; i++)
+      {
+        snprintf(ch->queue_names[i], CHANNEL_MQ_NAME_LEN, "/ipc_channel_%d_%u", (int) getpid(), i);
+        mq_unlink(ch->queue_names[i]);
+        ch->queues[i] = mq_open(ch->queue_names[i], O_CREAT | O_RDWR, S_IRUSR | S_IWUSR, &attr);
+        if(ch->queues[i] == (mqd_t) -1)
+          return -1;
+      }
+      break;
+
+    case CHANNEL_SHARED_MEMORY:
+      //ring indices are masked, so the number of slots has to be a power of two
+      for(slots = 1; slots < ch->depth; slots <<= 1)
+        ;
+      ch->depth = slots;
+      //whole cache lines, so the second ring's indices stay aligned and keep to lines of their own
+      ch->ring_size = sizeof(channel_ring_t) + slots * ch->wire_size;
+      ch->ring_size = (ch->ring_size + CHANNEL_CACHELINE - 1) & ~(size_t) (CHANNEL_CACHELINE - 1);
+
+      map_addr = mmap(NULL, 2 * ch->ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+      if(map_addr == MAP_FAILED)
+        return -1;
+
+      ch->rings[0] = (channel_ring_t *) map_addr;
+      ch->rings[1] = (channel_ring_t *) ((char *) map_addr + ch->ring_size);
+      for(i = 0; i < 2; i++)
+      {
+        atomic_init(&ch->rings[i]->head, 0);
+        atomic_init(&ch->rings[i]->tail, 0);
+      }
+      break;
+
+    default:
+      errno = EINVAL;
+      return -1;
+  }
+
+  //shared memory frames are built and checked in their ring slots, the other transports go through buffers
+  if(transport != CHANNEL_SHARED_MEMORY)
+  {
+    if((ch->tx_buf = malloc(ch->depth * ch->wire_size)) == NULL)
+      return -1;
+    if((ch->rx_buf = malloc(ch->depth * ch->wire_size)) == NULL)
+      return -1;
+  }
+
+  return 0;
+}
+
+/* Turns on credit based flow control. Must be called between channel_create() and fork() so both sides agree
+   on the window. Each direction has to hold a window of data frames plus the credit frames travelling beside
+   them, so the window is clamped to three less than the channel depth. The stash, which holds at most one
+   window, is allocated here once. */
+int channel_set_credits(channel_t *ch, unsigned int window)
+{
+  if(window > ch->depth - 3 && ch->depth > 3)
+    window = ch->depth - 3;
+  if(window == 0 || ch->depth <= 3)
+    window = 1;
+
+  free(ch->stash);
+  if((ch->stash = malloc(window * ch->frame_size)) == NULL)
+    return -1;
+
+  ch->credit_window = window;
+  ch->credits = window;
+  ch->sent = ch->consumed = ch->consumed_total = 0;
+  ch->stash_head = ch->stash_count = 0;
+  return 0;
+}
+
+/* Turns CRC32C checksums on or off. Must be called between channel_create() and fork(), like the credits, since
+   it applies to both directions: each side seals every frame it sends and drops every frame it receives which
+   does not carry a matching checksum, whether or not the frame says it has one. */
+void channel_set_checksum(channel_t *ch, bool enable)
+{
+  ch->checksum = enable;
+}
+
+void channel_set_send_hook(channel_t *ch, channel_send_hook_t hook, void *context)
+{
+  ch->send_hook = hook;
+  ch->send_hook_context = context;
+}
+
+int channel_attach(channel_t *ch, channel_side_t side)
+{
+  //index of the direction this side transmits on
+  int tx = (side == CHANNEL_PARENT) ? 0 : 1;
+  int rx = 1 - tx;
+
+  ch->side = side;
+
+  switch(ch->transport)
+  {
+    case CHANNEL_PIPE:
+      if(close(ch->pipes[tx][0]) == -1 || close(ch->pipes[rx][1]) == -1)
+        return -1;
+      ch->tx_fd = ch->pipes[tx][1];
+      ch->rx_fd = ch->pipes[rx][0];
+      break;
+
+    case CHANNEL_SOCKET:
+      if(close(ch->sockets[rx]) == -1)
+        return -1;
+      ch->tx_fd = ch->rx_fd = ch->sockets[tx];
+      break;
+
+    case CHANNEL_MESSAGE_QUEUE:
+      ch->tx_queue = ch->queues[tx];
+      ch->rx_queue = ch->queues[rx];
+      break;
+
+    case CHANNEL_SHARED_MEMORY:
+      ch->tx_ring = ch->rings[tx];
+      ch->rx_ring = ch->rings[rx];
+      break;
+  }
+  return 0;
+}
+
+/* Sends n frames laid out back to back in frames. They go out in batches as large as the transport depth and,
+   with flow control on, the credits in hand allow. */
+int channel_send_batch(channel_t *ch, const void *frames, unsigned int n)
+{
+  const unsigned char *src = (const unsigned char *) frames;
+  unsigned int chunk, i;
+
+  while(n > 0)
+  {
+    chunk = n;
+    if(ch->credit_window)
+    {
+      if(ch->credits == 0 && wait_for_credits(ch) == -1)
+        return -1;
+      if(chunk > ch->credits)
+        chunk = ch->credits;
+    }
+    chunk = wire_reserve(ch, chunk);
+
+    if(ch->send_hook)
+      ch->send_hook(ch->send_hook_context, ch, src, chunk);
+
+    for(i = 0; i < chunk; i++, src += ch->frame_size)
+      build_frame(ch, wire_tx_frame(ch, i), CHANNEL_FRAME_DATA, 0, src);
+
+    if(wire_write(ch, chunk) == -1)
+      return -1;
+
+    if(ch->credit_window)
+    {
+      ch->credits -= chunk;
+      ch->sent += chunk;
+    }
+    ch->stats.frames_sent += chunk;
+    ch->stats.batches_sent++;
+    n -= chunk;
+  }
+  return 0;
+}
+
+int channel_send(channel_t *ch, const void *frame)
+{
+  return channel_send_batch(ch, frame, 1);
+}
+
+/* Blocks until at least one frame arrives and returns up to max of them back to back in frames. Unlike the
+   rest of the API it returns the number of frames received, or -1 on failure. */
+int channel_recv_batch(channel_t *ch, void *frames, unsigned int max)
+{
+  unsigned char *dst = (unsigned char *) frames;
+  unsigned int received = 0;
+  int n, i;
+
+  if(max > ch->depth)
+    max = ch->depth;
+
+  while(ch->stash_count > 0 && received < max)
+  {
+    memcpy(dst + received++ * ch->frame_size, ch->stash + ch->stash_head * ch->frame_size, ch->frame_size);
+    ch->stash_head = (ch->stash_head + 1) % ch->credit_window;
+    ch->stash_count--;
+  }
+
+  while(received == 0)
+  {
+    if((n = wire_read(ch, max)) == -1)
+      return -1;
+
+    //there is room for every frame read, so take_frame() cannot fail here
+    for(i = 0; i < n; i++)
+      received += (unsigned int) take_frame(ch, wire_rx_frame(ch, i), dst + received * ch->frame_size);
+    wire_release(ch, n);
+
+    //a sender whose whole window was dropped on bad checksums would otherwise wait for credits forever
+    if(received == 0 && ch->consumed > 0 && send_credits(ch) == -1)
+      return -1;
+  }
+
+  ch->stats.frames_received += received;
+
+  //hand credits back once half the window has been delivered, so the sender never drains completely
+  if(ch->credit_window)
+  {
+    consume(ch, received);
+    if(ch->consumed >= (ch->credit_window + 1) / 2 && send_credits(ch) == -1)
+      return -1;
+  }
+  return (int) received;
+}
+
+int channel_recv(channel_t *ch, void *frame)
+{
+  return channel_recv_batch(ch, frame, 1) == -1 ? -1 : 0;
+}
+
+//Releases this side of the channel. The parent also unlinks the named message queues.
+void channel_close(channel_t *ch)
+{
+  unsigned int i;
+
+  switch(ch->transport)
+  {
+    case CHANNEL_PIPE:
+      close(ch->tx_fd);
+      close(ch->rx_fd);
+      break;
+
+    case CHANNEL_SOCKET:
+      close(ch->tx_fd);
+      break;
+
+    case CHANNEL_MESSAGE_QUEUE:
+      for(i = 0; i < 2; i++)
+      {
+        mq_close(ch->queues[i]);
+        if(ch->side == CHANNEL_PARENT)
+          mq_unlink(ch->queue_names[i]);
+      }
+      break;
+
+    case CHANNEL_SHARED_MEMORY:
+      munmap(ch->rings[0], 2 * ch->ring_size);
+      break;
+  }
+
+  free(ch->tx_buf);
+  free(ch->rx_buf);
+  free(ch->stash);
+  ch->tx_buf = ch->rx_buf = ch->stash = NULL;
+  ch->tx_fd = ch->rx_fd = -1;
+}
+
+const char *channel_transport_name(channel_transport_t transport)
+{
+  if((unsigned int) transport >= sizeof(transport_names) / sizeof(transport_names[0]))
+    return "unknown";
+  return transport_names[transport];
+}
+
+int channel_transport_parse(const char *name, channel_transport_t *transport)
+{
+  unsigned int i;
+
+  for(i = 0; i < sizeof(transport_names) / sizeof(transport_names[0]); i++)
+  {
+    if(!strcmp(name, transport_names[i]))
+    {
+      *transport = (channel_transport_t) i;
+      return 0;
+    }
+  }
+  errno = EINVAL;
+  return -1;
+}
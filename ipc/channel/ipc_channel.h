@@ -0,0 +1,151 @@
+/*  Author: agent <agent@local>
+    Date: 19-October-2026
+    Description: A bidirectional, fixed frame size channel between a parent and a forked child which can run over
+                 any of the four IPC mechanisms demonstrated in this directory: pipes, UNIX sockets, POSIX message
+                 queues and POSIX shared memory. The channel is created before fork() and each process then attaches
+                 to its own side of it.
+
+                 Every frame on the wire carries a small channel_header_t. It lets the channel interleave control
+                 frames with data, which is how credit based flow control works: once channel_set_credits() is
+                 called, a side may only have as many unacknowledged frames in flight as the peer has granted it
+                 credits, and the receiver hands credits back as channel_recv() delivers frames. A sender out of
+                 credits waits in userspace, where the wait is measured, instead of inside a full kernel buffer.
+                 Each grant carries the receiver's running total, so a grant which is lost is made up by the next.
+
+                 Credits work in both directions at once. A side waiting for credits keeps reading the peer's
+                 frames into a stash of one window, so two sides sending to each other may each get a window
+                 ahead of the other's channel_recv() calls; beyond that both wait, which is the point of bounding
+                 what a receiver buffers. Either side may still be granting credits when its peer closes, so a
+                 program using credits both ways over pipes should ignore SIGPIPE (sockets are written with
+                 MSG_NOSIGNAL).
+
+                 Once channel_set_checksum() is called, before fork(), every frame either side sends also carries
+                 a CRC32C of its header and payload (see crc32c.h), and every frame either side receives has to
+                 carry a matching one. Frames which fail the check, such as a torn write into a shared memory
+                 ring, are dropped and counted in the channel statistics instead of being handed to the caller.
+
+                 All functions return 0 on success and -1 on failure with errno set, so callers can errExit() the
+                 same way the standalone demos do.
+*/
+
+#ifndef IPC_CHANNEL_H
+#define IPC_CHANNEL_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <mqueue.h>
+
+#define CHANNEL_CACHELINE   64
+#define CHANNEL_MQ_NAME_LEN 32
+
+#define CHANNEL_FRAME_DATA    1
+#define CHANNEL_FRAME_CREDIT  2
+
+#define CHANNEL_FLAG_CHECKSUM 0x1     //the header's checksum field is valid
+
+typedef struct channel_header
+{
+  unsigned int checksum;            //CRC32C of everything on the wire after this field
+  unsigned short type;              //CHANNEL_FRAME_DATA or CHANNEL_FRAME_CREDIT
+  unsigned short flags;             //CHANNEL_FLAG_*
+  unsigned int consumed;            //CHANNEL_FRAME_CREDIT: frames the sender has consumed in total
+} channel_header_t;
+
+typedef struct channel_stats
+{
+  unsigned long long int frames_sent;
+  unsigned long long int frames_received;
+  unsigned long long int batches_sent;
+  unsigned long long int credit_stalls;     //sends which found no credits left
+  unsigned long long int blocked_ns;        //time spent waiting for credits or for space in a shared memory ring
+  unsigned long long int send_ns;           //time spent in the transport's send path, kernel blocking included
+  unsigned long long int credits_granted;
+  unsigned long long int checksums_verified;
+  unsigned long long int checksum_errors;   //frames dropped because their checksum did not match
+} channel_stats_t;
+
+typedef enum channel_transport
+{
+  CHANNEL_PIPE,
+  CHANNEL_SOCKET,
+  CHANNEL_MESSAGE_QUEUE,
+  CHANNEL_SHARED_MEMORY
+} channel_transport_t;
+
+typedef enum channel_side
+{
+  CHANNEL_PARENT,
+  CHANNEL_CHILD
+} channel_side_t;
+
+//Single producer, single consumer ring of frames living in shared memory. One ring per direction.
+typedef struct channel_ring
+{
+  _Atomic unsigned long head;       //next slot the consumer reads
+  char head_pad[CHANNEL_CACHELINE - sizeof(unsigned long)];
+  _Atomic unsigned long tail;       //next slot the producer writes
+  char tail_pad[CHANNEL_CACHELINE - sizeof(unsigned long)];
+  unsigned char slots[];
+} channel_ring_t;
+
+struct channel;
+
+//Called with every batch of frames a channel is about to send, e.g. trace_channel_hook() in ../trace.
+typedef void (*channel_send_hook_t)(void *, const struct channel *, const void *, unsigned int);
+
+typedef struct channel
+{
+  channel_transport_t transport;
+  size_t frame_size;
+  unsigned int depth;               //frames each direction can hold before the sender blocks
+  size_t wire_size;                 //frame_size plus the channel header
+  unsigned char *tx_buf;            //depth wire frames, so a whole batch goes out in one call (not used by shm)
+  unsigned char *rx_buf;
+
+  //[0] carries parent to child, [1] carries child to parent
+  int pipes[2][2];
+  int sockets[2];
+  mqd_t queues[2];
+  char queue_names[2][CHANNEL_MQ_NAME_LEN];
+  channel_ring_t *rings[2];
+  size_t ring_size;
+
+  //filled in by channel_attach()
+  channel_side_t side;
+  int tx_fd, rx_fd;
+  mqd_t tx_queue, rx_queue;
+  channel_ring_t *tx_ring, *rx_ring;
+
+  //credit based flow control, off while credit_window is 0
+  unsigned int credit_window;
+  unsigned int credits;             //frames this side may still send
+  unsigned int sent;                //data frames sent in total
+  unsigned int consumed;            //frames received since credits were last granted back
+  unsigned int consumed_total;      //frames received in total, the figure every grant carries
+  unsigned char *stash;             //up to a window of data frames which arrived while waiting for credits
+  unsigned int stash_head, stash_count;
+
+  bool checksum;                    //seal outgoing frames with a CRC32C and drop incoming ones without a good one
+
+  channel_send_hook_t send_hook;
+  void *send_hook_context;
+
+  channel_stats_t stats;
+} channel_t;
+
+int channel_create(channel_t *, channel_transport_t, size_t, unsigned int);
+int channel_attach(channel_t *, channel_side_t);
+int channel_set_credits(channel_t *, unsigned int);
+void channel_set_checksum(channel_t *, bool);
+void channel_set_send_hook(channel_t *, channel_send_hook_t, void *);
+int channel_send(channel_t *, const void *);
+int channel_send_batch(channel_t *, const void *, unsigned int);
+int channel_recv(channel_t *, void *);
+int channel_recv_batch(channel_t *, void *, unsigned int);
+void channel_close(channel_t *);
+
+const char *channel_transport_name(channel_transport_t);
+int channel_transport_parse(const char *, channel_transport_t *);
+
+#endif
@@ -0,0 +1,392 @@
+/*  Author: agent <agent@local>
+    Date: 19-October-2026
+    Description: A program to demonstrate and measure the CRC32C frame checksums of the IPC channel in ../channel.
+                 ○ Both CRC32C implementations in crc32c.c are checked against the standard check value and timed
+                   on their own for a few buffer sizes.
+                 ○ The parent then streams frames to a child as fast as the transport allows, once with checksums
+                   off and once with them on, and prints the throughput of both and the overhead of checking.
+                   Each run is repeated and the best one kept, so the comparison is not at the mercy of the
+                   scheduler. When more than one CPU is available the producer and the consumer are pinned to
+                   two of them, which is what full ring throughput means: each side then pays only for its own
+                   CRC. The overhead is checked against a target of OVERHEAD_TARGET percent and the program
+                   prints PASS or FAIL, exiting with a failure status on a miss.
+                 ○ Finally a few corrupted frames are written straight into a pipe channel between good ones to
+                   show that the receiver drops and counts them instead of handing them to the caller: frames
+                   with a payload bit flipped, frames whose only damage is a cleared checksum flag, and frames
+                   of all zeroes like a torn shared memory slot.
+
+                 Known result: on a machine with a single 2 GHz CPU the target is missed. Producer and consumer
+                 share the core, so both CRCs of every frame (about 7 GB/s each with the crc32 instruction) add
+                 to a ring which otherwise only copies memory: shm and pipe show 39-44 % with 256 byte frames and
+                 more with 4 KB ones. Socket and message queue runs are bound by system calls and swing by tens
+                 of percent from run to run.
+
+    To Build:    gcc -O2 -o ipc_checksum ipc_checksum.c ../channel/ipc_channel.c ../channel/crc32c.c -lrt
+    To Run:      ./ipc_checksum [pipe|socket|mqueue|shm] [frames] [frame size]
+*/
+
+#define _GNU_SOURCE     //sched_setaffinity()
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <stdbool.h>
+#include <sched.h>
+
+#include "../channel/ipc_channel.h"
+#include "../channel/crc32c.h"
+
+#define CHECK_VALUE     0xE3069283U     //CRC32C of "123456789"
+#define STREAM_BATCH    64              //frames the producer has ready at a time
+#define STREAM_REPEATS  3
+#define CORRUPT_FRAMES  6               //two of each kind of damage
+#define OVERHEAD_TARGET 5.0             //percent of the throughput without checksums, "a few percent"
+
+void errExit(char *);
+void check_implementations(void);
+double stream(channel_transport_t, unsigned int, size_t, bool, int);
+void corrupt(void);
+int nth_cpu(int);
+void pin_to_cpu(int);
+//Returns the nth CPU this process may run on, or -1 if it may run on fewer.
+int nth_cpu(int n)
+{
+  cpu_set_t set;
+  int cpu;
+
+  if(sched_getaffinity(0, sizeof(set), &set) == -1)
+    return -1;
+  for(cpu = 0; cpu < CPU_SETSIZE; cpu++)
+  {
+    if(CPU_ISSET(cpu, &set) && n-- == 0)
+      return cpu;
+  }
+  return -1;
+}
+
+void pin_to_cpu(int cpu)
+{
+  cpu_set_t set;
+
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  if(sched_setaffinity(0, sizeof(set), &set) == -1)
+    errExit("sched_setaffinity");
+}
+
+unsigned long long int now_ns(void);
+
+int main(int argc, char *argv[])
+{
+  channel_transport_t transport = CHANNEL_SHARED_MEMORY;
+  unsigned int frames = 1000000, i;
+  int producer_cpu, consumer_cpu;
+  size_t frame_size = 256;
+  double best_off = 0, best_on = 0, rate, overhead;
+
+  if(argc > 1 && channel_transport_parse(argv[1], &transport) == -1)
+  {
+    fprintf(stderr, "Usage: %s [pipe|socket|mqueue|shm] [frames] [frame size]\n", argv[0]);
+    exit(EXIT_FAILURE);
+  }
+  if(argc > 2)
+    frames = (unsigned int) atoi(argv[2]);
+  if(argc > 3)
+    frame_size = (size_t) atoi(argv[3]);
+
+  if(frames < 1 || frame_size < 1)
+  {
+    fprintf(stderr, "frames and frame size must be at least 1\n");
+    exit(EXIT_FAILURE);
+  }
+
+  check_implementations();
+
+  //the parent produces on the first CPU it may use, stream() puts each consuming child on the second
+  producer_cpu = nth_cpu(0);
+  consumer_cpu = nth_cpu(1);
+  if(consumer_cpu == -1)
+    printf("## PARENT ## Only one CPU available: producer and consumer share it.\n");
+  else
+  {
+    pin_to_cpu(producer_cpu);
+    printf("## PARENT ## Producer pinned to CPU %d, consumer to CPU %d.\n", producer_cpu, consumer_cpu);
+  }
+
+  //alternate the two so that a noisy moment does not land on one of them only
+  for(i = 0; i < STREAM_REPEATS; i++)
+  {
+    if((rate = stream(transport, frames, frame_size, false, consumer_cpu)) > best_off)
+      best_off = rate;
+    if((rate = stream(transport, frames, frame_size, true, consumer_cpu)) > best_on)
+      best_on = rate;
+  }
+
+  overhead = (best_off - best_on) * 100.0 / best_off;
+  printf("## PARENT ## %-6s | FRAME: %4zu bytes | CHECKSUMS OFF: %10.0f frames/s | ON: %10.0f frames/s | OVERHEAD: %5.2f %% ##\n",
+         channel_transport_name(transport), frame_size, best_off, best_on, overhead);
+
+  corrupt();
+
+  printf("## PARENT ## %s: checksum overhead %.2f %% against a target of %.2f %%.\n",
+         overhead <= OVERHEAD_TARGET ? "PASS" : "FAIL", overhead, OVERHEAD_TARGET);
+  exit(overhead <= OVERHEAD_TARGET ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+void check_implementations(void)
+{
+  static unsigned char buffer[65536], copy[65536];
+  const size_t sizes[] = { 32, 256, 4096, 65536 };
+  unsigned long long int start, hardware_ns, software_ns, bytes;
+  unsigned int i, r, rounds, sink = 0;
+
+  printf("## PARENT ## SSE4.2 crc32 instruction: %s\n", crc32c_hardware_available() ? "available" : "not available, using the table");
+
+  if(crc32c(0, "123456789", 9) != CHECK_VALUE || crc32c_software(0, "123456789", 9) != CHECK_VALUE)
+  {
+    fprintf(stderr, "## PARENT ## CRC32C check value mismatch: %08X (dispatched), %08X (table), expected %08X.\n",
+            crc32c(0, "123456789", 9), crc32c_software(0, "123456789", 9), CHECK_VALUE);
+    exit(EXIT_FAILURE);
+  }
+
+  //a checksum continued over two halves must equal the one over the whole
+  if(crc32c(crc32c(0, "1234", 4), "56789", 5) != CHECK_VALUE)
+  {
+    fprintf(stderr, "## PARENT ## CRC32C does not continue across calls.\n");
+    exit(EXIT_FAILURE);
+  }
+
+  for(i = 0; i < sizeof(buffer); i++)
+    buffer[i] = (unsigned char) (i * 131 + 7);
+
+  //copying while checksumming must give the same checksum and an exact copy, at every length and alignment
+  for(i = 0; i < 3 * 2048 + 64; i += 13)
+  {
+    if(crc32c_copy(i, copy + i % 8, buffer + i % 5, i) != crc32c(i, buffer + i % 5, i) || memcmp(copy + i % 8, buffer + i % 5, i))
+    {
+      fprintf(stderr, "## PARENT ## crc32c_copy() differs from crc32c() over %u bytes.\n", i);
+      exit(EXIT_FAILURE);
+    }
+  }
+
+  for(i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+  {
+    rounds = (unsigned int) ((64UL << 20) / sizes[i]);
+    bytes = (unsigned long long int) rounds * sizes[i];
+
+    start = now_ns();
+    for(r = 0; r < rounds; r++)
+      sink ^= crc32c(r, buffer, sizes[i]);
+    hardware_ns = now_ns() - start;
+
+    start = now_ns();
+    for(r = 0; r < rounds / 8; r++)
+      sink ^= crc32c_software(r, buffer, sizes[i]);
+    software_ns = (now_ns() - start) * 8;
+
+    printf("## PARENT ## CRC32C %5zu bytes | DISPATCHED: %7.2f GB/s | TABLE: %7.2f GB/s ##\n",
+           sizes[i], bytes / (double) hardware_ns, bytes / (double) software_ns);
+  }
+
+  //keeps the compiler from dropping the timed loops
+  if(sink == 0x12345678)
+    printf(" ");
+}
+
+/* Streams frames from the parent to a child which only receives them, on consumer_cpu unless that is -1.
+   Returns the throughput in frames/s. */
+double stream(channel_transport_t transport, unsigned int frames, size_t frame_size, bool checksum, int consumer_cpu)
+{
+  pid_t Child_Pid = 0;
+  channel_t ch;
+  unsigned char *batch;
+  unsigned int sent = 0, received = 0, chunk, i;
+  unsigned long long int start, elapsed;
+  int n, status;
+
+  if(channel_create(&ch, transport, frame_size, STREAM_BATCH) == -1)
+    errExit("channel_create");
+
+  channel_set_checksum(&ch, checksum);
+
+  if((batch = malloc(STREAM_BATCH * frame_size)) == NULL)
+    errExit("malloc");
+
+  switch (Child_Pid = fork())
+  {
+    case -1: /* fork() failed */
+      errExit("fork");
+      break;
+
+    case 0: /* Child of successful fork() comes here */
+      if(consumer_cpu != -1)
+        pin_to_cpu(consumer_cpu);
+      if(channel_attach(&ch, CHANNEL_CHILD) == -1)
+        errExit("child channel_attach");
+
+      while(received < frames)
+      {
+        if((n = channel_recv_batch(&ch, batch, STREAM_BATCH)) == -1)
+          errExit("receiving from parent to child");
+        received += (unsigned int) n;
+      }
+
+      //every frame has to have been checked when checksums are on, and none may have failed
+      if(ch.stats.checksum_errors || ch.stats.checksums_verified != (checksum ? frames : 0))
+      {
+        fprintf(stderr, "## CHILD ## %llu frames verified, %llu failed, out of %u.\n",
+                ch.stats.checksums_verified, ch.stats.checksum_errors, frames);
+        _exit(EXIT_FAILURE);
+      }
+
+      channel_close(&ch);
+      _exit(EXIT_SUCCESS);
+
+    default: /* Parent comes here after successful fork() */
+      if(channel_attach(&ch, CHANNEL_PARENT) == -1)
+        errExit("parent channel_attach");
+
+      for(i = 0; i < STREAM_BATCH * frame_size; i++)
+        batch[i] = (unsigned char) i;
+
+      start = now_ns();
+      while(sent < frames)
+      {
+        chunk = frames - sent < STREAM_BATCH ? frames - sent : STREAM_BATCH;
+        if(channel_send_batch(&ch, batch, chunk) == -1)
+          errExit("sending from parent to child");
+        sent += chunk;
+      }
+      if(waitpid(Child_Pid, &status, 0) == -1)
+        errExit("waitpid");
+      elapsed = now_ns() - start;
+
+      if(!WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS)
+      {
+        fprintf(stderr, "## PARENT ## The child did not verify the stream.\n");
+        exit(EXIT_FAILURE);
+      }
+
+      printf("## PARENT ## %-6s | CHECKSUMS: %-3s | %10.0f frames/s | %8.2f MB/s ##\n", channel_transport_name(transport),
+             checksum ? "on" : "off", frames * 1e9 / elapsed, frames * (double) frame_size * 1e3 / elapsed);
+      break;
+  }
+
+  channel_close(&ch);
+  free(batch);
+  return frames * 1e9 / elapsed;
+}
+
+/* Sends good frames through the channel and, between them, wire frames damaged after the checksum was computed.
+   The child must receive exactly the good ones. */
+void corrupt(void)
+{
+  pid_t Child_Pid = 0;
+  channel_t ch;
+  channel_header_t header;
+  unsigned int value, i;
+  unsigned char wire[sizeof(channel_header_t) + sizeof(unsigned int)];
+  int status;
+
+  if(channel_create(&ch, CHANNEL_PIPE, sizeof(value), CORRUPT_FRAMES + 1) == -1)
+    errExit("channel_create");
+
+  channel_set_checksum(&ch, true);
+
+  fflush(stdout);     //or the child would print it again
+  switch (Child_Pid = fork())
+  {
+    case -1: /* fork() failed */
+      errExit("fork");
+      break;
+
+    case 0: /* Child of successful fork() comes here */
+      if(channel_attach(&ch, CHANNEL_CHILD) == -1)
+        errExit("child channel_attach");
+
+      for(i = 0; i <= CORRUPT_FRAMES; i++)
+      {
+        if(channel_recv(&ch, &value) == -1)
+          errExit("receiving from parent to child");
+        if(value != i)
+        {
+          fprintf(stderr, "## CHILD ## Received %u, expected %u.\n", value, i);
+          _exit(EXIT_FAILURE);
+        }
+      }
+
+      printf("## CHILD ## Received %u good frames, dropped %llu with a bad checksum.\n", CORRUPT_FRAMES + 1, ch.stats.checksum_errors);
+      fflush(stdout);
+      channel_close(&ch);
+      _exit(ch.stats.checksum_errors == CORRUPT_FRAMES ? EXIT_SUCCESS : EXIT_FAILURE);
+
+    default: /* Parent comes here after successful fork() */
+      if(channel_attach(&ch, CHANNEL_PARENT) == -1)
+        errExit("parent channel_attach");
+
+      for(i = 0; i <= CORRUPT_FRAMES; i++)
+      {
+        if(channel_send(&ch, &i) == -1)
+          errExit("sending from parent to child");
+        if(i == CORRUPT_FRAMES)
+          break;
+
+        //a frame sealed for value i, then damaged on the way
+        value = i;
+        header.type = CHANNEL_FRAME_DATA;
+        header.flags = CHANNEL_FLAG_CHECKSUM;
+        header.consumed = 0;
+        header.checksum = 0;
+        memcpy(wire, &header, sizeof(header));
+        memcpy(wire + sizeof(header), &value, sizeof(value));
+        header.checksum = crc32c(0, wire + sizeof(header.checksum), sizeof(wire) - sizeof(header.checksum));
+        memcpy(wire, &header, sizeof(header));
+        switch(i % 3)
+        {
+          case 0: //one bit of the payload
+            wire[sizeof(header) + i % sizeof(value)] ^= 1U << i;
+            break;
+
+          case 1: //only the flag which says the frame is checksummed
+            wire[offsetof(channel_header_t, flags)] ^= CHANNEL_FLAG_CHECKSUM;
+            break;
+
+          case 2: //the whole frame, as a slot which was never written
+            bzero(wire, sizeof(wire));
+            break;
+        }
+        if(write(ch.tx_fd, wire, sizeof(wire)) != (ssize_t) sizeof(wire))
+          errExit("writing corrupted frame");
+      }
+
+      if(waitpid(Child_Pid, &status, 0) == -1)
+        errExit("waitpid");
+      channel_close(&ch);
+
+      if(!WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS)
+      {
+        fprintf(stderr, "## PARENT ## Corrupted frames were not all caught.\n");
+        exit(EXIT_FAILURE);
+      }
+      break;
+  }
+}
+
+unsigned long long int now_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (unsigned long long int) ts.tv_sec * 1000000000ULL + (unsigned long long int) ts.tv_nsec;
+}
+
+//Function to print the error to STDOUT and exit.
+void errExit(char *strError)
+{
+  perror(strError);
+  exit(EXIT_FAILURE);
+}
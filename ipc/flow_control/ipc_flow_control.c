@@ -0,0 +1,261 @@
+/*  Author: agent <agent@local>
+    Date: 19-October-2026
+    Description: A program to demonstrate credit based flow control on the IPC channel in ../channel.
+                 The parent is a fast producer streaming payload_t frames to a child which spends work_us on each
+                 one. Without flow control the parent simply blocks whenever the kernel buffer (or the 5 message
+                 mq_maxmsg of the message queue demo) fills, and nothing shows how long or how often. With credits
+                 the child grants the parent a window of frames, the parent sends as many frames per call as its
+                 credits allow, and every stall is counted and timed on the sending side.
+
+                 The stream is run once without and once with credits, and the sender's channel statistics are
+                 printed for both. Both runs hand the channel the same batches, so the difference between them
+                 is down to flow control alone.
+
+                 Finally both sides exchange frames at once: each sends a burst of one window and only then
+                 receives the peer's burst. A window is as far as two senders may get ahead of each other: a
+                 side waiting for credits keeps the peer's frames in a stash of one window until it receives
+                 them, and credits them only then, so the receiver's buffering stays bounded. The exchange checks
+                 that the stash holds no more than that, and that nothing is lost or reordered.
+
+    To Build:    gcc -O2 -o ipc_flow_control ipc_flow_control.c ../channel/ipc_channel.c ../channel/crc32c.c -lrt
+    To Run:      ./ipc_flow_control [pipe|socket|mqueue|shm] [frames] [window] [work_us]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <stdbool.h>
+#include <signal.h>
+
+#include "../channel/ipc_channel.h"
+
+#define PRODUCER_BATCH  64      //frames the producer has ready at a time
+
+//Structure of the data which is communicated between the parent and the child.
+typedef struct payload
+{
+  char string[16];
+  bool led_state;
+} payload_t;
+
+void errExit(char *);
+void run(channel_transport_t, unsigned int, unsigned int, unsigned int);
+void exchange(channel_transport_t, unsigned int, unsigned int);
+void exchange_side(channel_t *, unsigned int, unsigned int, unsigned int);
+unsigned long long int now_ns(void);
+
+int main(int argc, char *argv[])
+{
+  channel_transport_t transport = CHANNEL_PIPE;
+  unsigned int frames = 200000, window = 32, work_us = 1;
+
+  if(argc > 1 && channel_transport_parse(argv[1], &transport) == -1)
+  {
+    fprintf(stderr, "Usage: %s [pipe|socket|mqueue|shm] [frames] [window] [work_us]\n", argv[0]);
+    exit(EXIT_FAILURE);
+  }
+  if(argc > 2)
+    frames = (unsigned int) atoi(argv[2]);
+  if(argc > 3)
+    window = (unsigned int) atoi(argv[3]);
+  if(argc > 4)
+    work_us = (unsigned int) atoi(argv[4]);
+
+  run(transport, frames, 0, work_us);
+  run(transport, frames, window, work_us);
+
+  //each side of the exchange may still be granting credits when the other closes its end of the pipe
+  signal(SIGPIPE, SIG_IGN);
+  exchange(transport, frames, window);
+
+  exit(EXIT_SUCCESS);
+}
+
+//Streams frames from the parent to a slow child. A window of 0 leaves flow control off.
+void run(channel_transport_t transport, unsigned int frames, unsigned int window, unsigned int work_us)
+{
+  pid_t Child_Pid = 0;
+  channel_t ch;
+  payload_t batch[PRODUCER_BATCH];
+  unsigned int sent = 0, received = 0, chunk, i;
+  unsigned long long int start, elapsed, deadline;
+  int n;
+
+  //deep enough that the window, not the channel, is the limit
+  if(channel_create(&ch, transport, sizeof(payload_t), window + PRODUCER_BATCH) == -1)
+    errExit("channel_create");
+
+  if(window && channel_set_credits(&ch, window) == -1)
+    errExit("channel_set_credits");
+
+  switch (Child_Pid = fork())
+  {
+    case -1: /* fork() failed */
+      errExit("fork");
+      break;
+
+    case 0: /* Child of successful fork() comes here */
+      if(channel_attach(&ch, CHANNEL_CHILD) == -1)
+        errExit("child channel_attach");
+
+      while(received < frames)
+      {
+        if((n = channel_recv_batch(&ch, batch, PRODUCER_BATCH)) == -1)
+          errExit("receiving from parent to child");
+
+        //simulated processing cost of every frame
+        deadline = now_ns() + (unsigned long long int) n * work_us * 1000ULL;
+        while(now_ns() < deadline)
+          ;
+        received += (unsigned int) n;
+      }
+
+      channel_close(&ch);
+      _exit(EXIT_SUCCESS);
+
+    default: /* Parent comes here after successful fork() */
+      if(channel_attach(&ch, CHANNEL_PARENT) == -1)
+        errExit("parent channel_attach");
+
+      for(i = 0; i < PRODUCER_BATCH; i++)
+      {
+        strcpy(batch[i].string, "Hello");
+        batch[i].led_state = i & 1;
+      }
+
+      start = now_ns();
+      while(sent < frames)
+      {
+        chunk = frames - sent < PRODUCER_BATCH ? frames - sent : PRODUCER_BATCH;
+        if(channel_send_batch(&ch, batch, chunk) == -1)
+          errExit("sending from parent to child");
+        sent += chunk;
+      }
+      waitpid(Child_Pid, NULL, 0);
+      elapsed = now_ns() - start;
+
+      printf("## PARENT ## %-6s | CREDITS: %-3s | WINDOW: %3u | %10.0f frames/s | BATCHES: %7llu | STALLS: %6llu | BLOCKED: %8.2f ms | IN SEND: %8.2f ms ##\n",
+             channel_transport_name(transport), window ? "on" : "off", ch.credit_window, frames * 1e9 / elapsed,
+             ch.stats.batches_sent, ch.stats.credit_stalls, ch.stats.blocked_ns / 1e6, ch.stats.send_ns / 1e6);
+
+      channel_close(&ch);
+      break;
+  }
+}
+
+/* Both sides send bursts of one window to each other, and each side only starts receiving once its own burst
+   is out. Every frame carries its index so either side can check nothing was lost or reordered. */
+void exchange(channel_transport_t transport, unsigned int frames, unsigned int window)
+{
+  pid_t Child_Pid = 0;
+  channel_t ch;
+  unsigned long long int start, elapsed;
+  int status;
+
+  if(channel_create(&ch, transport, sizeof(payload_t), window + PRODUCER_BATCH) == -1)
+    errExit("channel_create");
+
+  if(channel_set_credits(&ch, window) == -1)
+    errExit("channel_set_credits");
+
+  switch (Child_Pid = fork())
+  {
+    case -1: /* fork() failed */
+      errExit("fork");
+      break;
+
+    case 0: /* Child of successful fork() comes here */
+      if(channel_attach(&ch, CHANNEL_CHILD) == -1)
+        errExit("child channel_attach");
+
+      exchange_side(&ch, frames, ch.credit_window, 1);
+
+      channel_close(&ch);
+      _exit(EXIT_SUCCESS);
+
+    default: /* Parent comes here after successful fork() */
+      if(channel_attach(&ch, CHANNEL_PARENT) == -1)
+        errExit("parent channel_attach");
+
+      start = now_ns();
+      exchange_side(&ch, frames, ch.credit_window, 0);
+      if(waitpid(Child_Pid, &status, 0) == -1)
+        errExit("waitpid");
+      elapsed = now_ns() - start;
+
+      if(!WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS)
+      {
+        fprintf(stderr, "## PARENT ## The child's side of the exchange failed.\n");
+        exit(EXIT_FAILURE);
+      }
+
+      printf("## PARENT ## %-6s | TWO WAY     | WINDOW: %3u | %10.0f frames/s each way | BURST: %4u | STALLS: %6llu | BLOCKED: %8.2f ms ##\n",
+             channel_transport_name(transport), ch.credit_window, frames * 1e9 / elapsed, ch.credit_window,
+             ch.stats.credit_stalls, ch.stats.blocked_ns / 1e6);
+
+      channel_close(&ch);
+      break;
+  }
+}
+
+void exchange_side(channel_t *ch, unsigned int frames, unsigned int burst, unsigned int side)
+{
+  payload_t batch[PRODUCER_BATCH];
+  unsigned int sent = 0, received = 0, expected = 0, chunk, goal, i;
+  int n;
+
+  while(received < frames)
+  {
+    goal = frames - sent < burst ? frames : sent + burst;
+    for(; sent < goal; sent += chunk)
+    {
+      chunk = goal - sent < PRODUCER_BATCH ? goal - sent : PRODUCER_BATCH;
+      for(i = 0; i < chunk; i++)
+      {
+        snprintf(batch[i].string, sizeof(batch[i].string), "%u", sent + i);
+        batch[i].led_state = side;
+      }
+      if(channel_send_batch(ch, batch, chunk) == -1)
+        errExit("sending burst");
+      if(ch->stash_count > ch->credit_window)
+      {
+        fprintf(stderr, "## %s ## %u frames stashed, more than the window.\n", side ? "CHILD" : "PARENT", ch->stash_count);
+        exit(EXIT_FAILURE);
+      }
+    }
+
+    goal = frames - received < burst ? frames : received + burst;
+    while(received < goal)
+    {
+      if((n = channel_recv_batch(ch, batch, goal - received < PRODUCER_BATCH ? goal - received : PRODUCER_BATCH)) == -1)
+        errExit("receiving burst");
+      for(i = 0; i < (unsigned int) n; i++, received++)
+      {
+        if((unsigned int) atoi(batch[i].string) != expected++ || batch[i].led_state == side)
+        {
+          fprintf(stderr, "## %s ## Frame %u arrived out of order.\n", side ? "CHILD" : "PARENT", received);
+          exit(EXIT_FAILURE);
+        }
+      }
+    }
+  }
+}
+
+unsigned long long int now_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (unsigned long long int) ts.tv_sec * 1000000000ULL + (unsigned long long int) ts.tv_nsec;
+}
+
+//Function to print the error to STDOUT and exit.
+void errExit(char *strError)
+{
+  perror(strError);
+  exit(EXIT_FAILURE);
+}
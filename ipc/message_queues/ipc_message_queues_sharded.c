@@ -0,0 +1,312 @@
+/*  Author: agent <agent@local>
+    Date: 19-October-2026
+    Description: A program to demonstrate sharded POSIX message queues in Linux.
+                 ipc_message_queues.c pushes every message through the single queue "/message_queue", so all
+                 traffic goes through one kernel queue and its lock and only one consumer can drain it. Here the
+                 parent opens K queues ("/message_queue_0" .. "/message_queue_<K-1>") and forks one consumer per
+                 queue. Every message carries a key (the payload string) and is routed to the shard picked by the
+                 FNV-1a hash of that key, so all messages with the same key go through the same queue to the same
+                 consumer and stay in order, while different keys are processed on different cores.
+
+                 Each consumer checks that it sees every key's messages in sequence. The run is repeated for
+                 1, 2, 4 .. K shards and the throughput of each is printed. A consumer which fails exits early;
+                 the parent notices when that shard's queue stays full, stops the other consumers and reports it
+                 rather than waiting on the full queue forever.
+
+    To Build:    gcc -O2 -o ipc_message_queues_sharded ipc_message_queues_sharded.c -lrt
+    To Run:      ./ipc_message_queues_sharded [shards] [messages] [keys] [work_us]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <mqueue.h>
+#include <stdbool.h>
+#include <time.h>
+#include <signal.h>
+#include <errno.h>
+
+#define MAX_SHARDS      64
+#define MAX_KEYS        4096
+#define STOP_KEY        ((unsigned int) -1)
+#define SEND_TIMEOUT_NS 100000000ULL    //how long a full queue is waited on before checking its consumer is alive
+
+//Structure of the data which is communicated between the parent and the children.
+typedef struct payload
+{
+  char string[16];
+  bool led_state;
+} payload_t;
+
+//A payload with its key number and its position among the messages with that key.
+typedef struct sharded_message
+{
+  unsigned int key;
+  unsigned int sequence;
+  payload_t payload;
+} sharded_message_t;
+
+void errExit(char *);
+unsigned int shard_of(const char *, unsigned int);
+void consume(unsigned int, mqd_t, unsigned int);
+void run(unsigned int, unsigned int, unsigned int, unsigned int);
+int send_to_shard(mqd_t, pid_t, const sharded_message_t *);
+void abort_run(unsigned int, pid_t *, mqd_t *, char [][32], unsigned int);
+unsigned long long int now_ns(void);
+
+int main(int argc, char *argv[])
+{
+  unsigned int shards = 4, messages = 200000, keys = 256, work_us = 5, k;
+
+  if(argc > 1)
+    shards = (unsigned int) atoi(argv[1]);
+  if(argc > 2)
+    messages = (unsigned int) atoi(argv[2]);
+  if(argc > 3)
+    keys = (unsigned int) atoi(argv[3]);
+  if(argc > 4)
+    work_us = (unsigned int) atoi(argv[4]);
+
+  if(shards < 1 || shards > MAX_SHARDS || keys < 1 || keys > MAX_KEYS)
+  {
+    fprintf(stderr, "Usage: %s [shards 1..%u] [messages] [keys 1..%u] [work_us]\n", argv[0], MAX_SHARDS, MAX_KEYS);
+    exit(EXIT_FAILURE);
+  }
+
+  for(k = 1; k < shards; k *= 2)
+    run(k, messages, keys, work_us);
+  run(shards, messages, keys, work_us);
+
+  exit(EXIT_SUCCESS);
+}
+
+/* FNV-1a hash of the message key, reduced to a shard number. The hash ends with a multiply, which only carries
+   low bits upwards, so its low bits depend on nothing but the low bits of each key byte ("a" and "q" always
+   share a shard among 16 or fewer). The high half is folded down before reducing to mix the whole key in. */
+unsigned int shard_of(const char *key, unsigned int shards)
+{
+  unsigned int hash = 2166136261U;
+
+  while(*key)
+  {
+    hash ^= (unsigned char) *key++;
+    hash *= 16777619U;
+  }
+  return (hash ^ (hash >> 16)) % shards;
+}
+
+/* Sends a message to a shard's queue. While the queue stays full the shard's consumer is checked on, so one
+   which has exited makes this fail with ESRCH instead of blocking forever. */
+int send_to_shard(mqd_t mq, pid_t consumer, const sharded_message_t *message)
+{
+  struct timespec ts;
+  unsigned long long int deadline;
+  siginfo_t info;
+
+  while(1)
+  {
+    //mq_timedsend() takes an absolute CLOCK_REALTIME deadline
+    clock_gettime(CLOCK_REALTIME, &ts);
+    deadline = (unsigned long long int) ts.tv_sec * 1000000000ULL + (unsigned long long int) ts.tv_nsec + SEND_TIMEOUT_NS;
+    ts.tv_sec = (time_t) (deadline / 1000000000ULL);
+    ts.tv_nsec = (long) (deadline % 1000000000ULL);
+
+    if(mq_timedsend(mq, (const char *) message, sizeof(*message), 0, &ts) == 0)
+      return 0;
+    if(errno == EINTR)
+      continue;
+    if(errno != ETIMEDOUT)
+      return -1;
+
+    //a consumer which exited is left unreaped, so abort_run() still finds it
+    info.si_pid = 0;
+    if(waitid(P_PID, (id_t) consumer, &info, WEXITED | WNOHANG | WNOWAIT) == -1)
+      return -1;
+    if(info.si_pid == consumer)
+    {
+      errno = ESRCH;
+      return -1;
+    }
+  }
+}
+
+//Stops every consumer of a run in which the consumer of shard dead exited early, then exits with failure.
+void abort_run(unsigned int shards, pid_t *Child_Pid, mqd_t *mq, char name[][32], unsigned int dead)
+{
+  unsigned int k;
+
+  for(k = 0; k < shards; k++)
+  {
+    if(k != dead)
+      kill(Child_Pid[k], SIGTERM);
+    waitpid(Child_Pid[k], NULL, 0);
+    mq_close(mq[k]);
+    mq_unlink(name[k]);
+  }
+
+  fprintf(stderr, "## PARENT ## The consumer of shard %u exited early, the run is abandoned.\n", dead);
+  exit(EXIT_FAILURE);
+}
+
+void run(unsigned int shards, unsigned int messages, unsigned int keys, unsigned int work_us)
+{
+  pid_t Child_Pid[MAX_SHARDS];
+  mqd_t mq[MAX_SHARDS];
+  char name[MAX_SHARDS][32];
+  struct mq_attr attr;
+  sharded_message_t message;
+  unsigned int sequence[MAX_KEYS], per_shard[MAX_SHARDS], i, k;
+  unsigned long long int start, elapsed;
+  int status, failed = 0;
+
+  bzero(&attr, sizeof(attr));
+  attr.mq_flags = O_RDWR;
+  attr.mq_maxmsg = 5;
+  attr.mq_msgsize = sizeof(sharded_message_t);
+
+  //every queue exists before any consumer is forked, so nothing is sent to a queue nobody has opened yet
+  for(k = 0; k < shards; k++)
+  {
+    snprintf(name[k], sizeof(name[k]), "/message_queue_%u", k);
+    mq_unlink(name[k]);
+    mq[k] = mq_open(name[k], O_CREAT | O_RDWR, S_IRUSR | S_IWUSR, &attr);
+    if(mq[k] == -1)
+      errExit("parent side creation of message queue descriptor");
+  }
+
+  for(k = 0; k < shards; k++)
+  {
+    switch (Child_Pid[k] = fork())
+    {
+      case -1: /* fork() failed */
+        errExit("fork");
+        break;
+
+      case 0: /* Child of successful fork() comes here */
+        consume(k, mq[k], work_us);
+        break;
+
+      default: /* Parent comes here after successful fork() */
+        break;
+    }
+  }
+
+  bzero(sequence, sizeof(sequence));
+  bzero(per_shard, sizeof(per_shard));
+
+  start = now_ns();
+  for(i = 0; i < messages; i++)
+  {
+    message.key = i % keys;
+    message.sequence = sequence[message.key]++;
+    snprintf(message.payload.string, sizeof(message.payload.string), "led%u", message.key);
+    message.payload.led_state = message.sequence & 1;
+
+    k = shard_of(message.payload.string, shards);
+    if(send_to_shard(mq[k], Child_Pid[k], &message) == -1)
+    {
+      if(errno == ESRCH)
+        abort_run(shards, Child_Pid, mq, name, k);
+      errExit("sending from parent to shard");
+    }
+    per_shard[k]++;
+  }
+
+  message.key = STOP_KEY;
+  for(k = 0; k < shards; k++)
+  {
+    if(send_to_shard(mq[k], Child_Pid[k], &message) == -1)
+    {
+      if(errno == ESRCH)
+        abort_run(shards, Child_Pid, mq, name, k);
+      errExit("sending stop to shard");
+    }
+  }
+
+  for(k = 0; k < shards; k++)
+  {
+    if(waitpid(Child_Pid[k], &status, 0) == -1)
+      errExit("waitpid");
+    if(!WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS)
+      failed = 1;
+  }
+  elapsed = now_ns() - start;
+
+  for(k = 0; k < shards; k++)
+  {
+    mq_close(mq[k]);
+    mq_unlink(name[k]);
+  }
+
+  if(failed)
+  {
+    fprintf(stderr, "## PARENT ## A consumer saw messages out of order.\n");
+    exit(EXIT_FAILURE);
+  }
+
+  printf("## PARENT ## SHARDS: %2u | MESSAGES: %u | KEYS: %u | %10.0f msgs/s | PER SHARD:", shards, messages, keys, messages * 1e9 / elapsed);
+  for(k = 0; k < shards; k++)
+    printf(" %u", per_shard[k]);
+  printf(" ##\n");
+}
+
+//One consumer per shard. Exits with failure if any key's messages arrive out of order.
+void consume(unsigned int shard, mqd_t mq, unsigned int work_us)
+{
+  static unsigned int expected[MAX_KEYS];
+  sharded_message_t message;
+  unsigned long long int deadline;
+
+  bzero(expected, sizeof(expected));
+
+  while(1)
+  {
+    if(mq_receive(mq, (char *) &message, sizeof(message), NULL) == -1)
+      errExit("receiving from parent to shard");
+
+    if(message.key == STOP_KEY)
+      break;
+
+    if(message.key >= MAX_KEYS)
+    {
+      fprintf(stderr, "## CHILD %u ## Key %u is out of range.\n", shard, message.key);
+      _exit(EXIT_FAILURE);
+    }
+    if(message.sequence != expected[message.key])
+    {
+      fprintf(stderr, "## CHILD %u ## Key %u: expected message %u, received %u.\n", shard, message.key, expected[message.key], message.sequence);
+      _exit(EXIT_FAILURE);
+    }
+    expected[message.key]++;
+
+    //the same modification the standalone demo makes, plus a simulated processing cost
+    strncat(message.payload.string, " World", sizeof(message.payload.string) - strlen(message.payload.string) - 1);
+    message.payload.led_state = !message.payload.led_state;
+    deadline = now_ns() + work_us * 1000ULL;
+    while(now_ns() < deadline)
+      ;
+  }
+
+  mq_close(mq);
+  _exit(EXIT_SUCCESS);
+}
+
+unsigned long long int now_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (unsigned long long int) ts.tv_sec * 1000000000ULL + (unsigned long long int) ts.tv_nsec;
+}
+
+//Function to print the error to STDOUT and exit.
+void errExit(char *strError)
+{
+  perror(strError);
+  exit(EXIT_FAILURE);
+}
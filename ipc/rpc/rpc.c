@@ -0,0 +1,154 @@
+/*  Author: agent <agent@local>
+    Date: 19-October-2026
+    Description: Implementation of the pipelined RPC client and server declared in rpc.h.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+
+#include "rpc.h"
+
+static unsigned long long int now_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (unsigned long long int) ts.tv_sec * 1000000000ULL + (unsigned long long int) ts.tv_nsec;
+}
+
+int rpc_client_init(rpc_client_t *client, channel_t *ch, unsigned int window, rpc_reply_handler_t on_reply, void *context)
+{
+  unsigned int i;
+
+  if(window < 1 || window > RPC_MAX_WINDOW)
+  {
+    errno = EINVAL;
+    return -1;
+  }
+
+  bzero(client, sizeof(rpc_client_t));
+  client->ch = ch;
+  client->window = window;
+  client->on_reply = on_reply;
+  client->on_reply_context = context;
+  for(i = 0; i < window; i++)
+    client->free_slots[client->nfree++] = window - 1 - i;
+
+  return 0;
+}
+
+//Sends a request, first waiting for a reply if the window is full. The request's correlation ID goes to id.
+int rpc_submit(rpc_client_t *client, const payload_t *request, unsigned long long int *id)
+{
+  rpc_frame_t frame;
+  rpc_pending_t *pending;
+  unsigned int slot;
+
+  if(client->in_flight == client->window && rpc_complete_one(client) == -1)
+    return -1;
+
+  slot = client->free_slots[client->nfree - 1];
+  pending = &client->pending[slot];
+
+  frame.id = (client->next_seq << RPC_SLOT_BITS) | slot;
+  frame.payload = *request;
+  pending->sent_ns = now_ns();
+  if(channel_send(client->ch, &frame) == -1)
+    return -1;
+
+  client->nfree--;
+  client->next_seq++;
+  client->in_flight++;
+  pending->id = frame.id;
+  pending->busy = true;
+  pending->request = *request;
+
+  if(id)
+    *id = frame.id;
+  return 0;
+}
+
+//Receives one reply, whichever request it answers, and hands both to the reply handler.
+int rpc_complete_one(rpc_client_t *client)
+{
+  rpc_frame_t frame;
+  rpc_pending_t *pending;
+  unsigned int slot;
+  unsigned long long int seq;
+
+  if(channel_recv(client->ch, &frame) == -1)
+    return -1;
+
+  slot = (unsigned int) (frame.id & (RPC_MAX_WINDOW - 1));
+  pending = &client->pending[slot];
+  if(slot >= client->window || !pending->busy || pending->id != frame.id)
+  {
+    errno = EPROTO;
+    return -1;
+  }
+
+  seq = frame.id >> RPC_SLOT_BITS;
+  if(client->completed && seq < client->highest_seq)
+    client->out_of_order++;
+  else
+    client->highest_seq = seq;
+
+  client->latency_ns += now_ns() - pending->sent_ns;
+  client->completed++;
+  client->in_flight--;
+  client->free_slots[client->nfree++] = slot;
+  pending->busy = false;
+
+  if(client->on_reply)
+    client->on_reply(client->on_reply_context, &pending->request, &frame.payload);
+  return 0;
+}
+
+int rpc_drain(rpc_client_t *client)
+{
+  while(client->in_flight > 0)
+  {
+    if(rpc_complete_one(client) == -1)
+      return -1;
+  }
+  return 0;
+}
+
+/* Server side. Requests are taken in groups of up to reorder and answered last first, which is the kind of
+   reordering a server with several workers produces. reorder must not exceed the client's window, or the
+   server would wait for requests the client is not allowed to send yet. */
+int rpc_serve(channel_t *ch, unsigned int requests, unsigned int reorder, rpc_request_handler_t handler, void *context)
+{
+  rpc_frame_t frames[RPC_MAX_REORDER];
+  unsigned int served = 0, batch, i;
+
+  if(reorder < 1 || reorder > RPC_MAX_REORDER)
+  {
+    errno = EINVAL;
+    return -1;
+  }
+
+  while(served < requests)
+  {
+    batch = requests - served < reorder ? requests - served : reorder;
+
+    for(i = 0; i < batch; i++)
+    {
+      if(channel_recv(ch, &frames[i]) == -1)
+        return -1;
+      handler(context, &frames[i].payload);
+    }
+
+    while(batch > 0)
+    {
+      if(channel_send(ch, &frames[--batch]) == -1)
+        return -1;
+      served++;
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,81 @@
+/*  Author: agent <agent@local>
+    Date: 19-October-2026
+    Description: Pipelined request/response RPC of payload_t over the IPC channel in ../channel.
+                 Every request is tagged with a correlation ID. The client keeps up to a window of requests in
+                 flight and matches each reply to its request by ID, so the server is free to answer out of
+                 order; every reply is handed to the client's reply handler together with the request it answers.
+
+                 The low RPC_SLOT_BITS of a correlation ID name the pending slot which holds the request and the
+                 high bits are a sequence number, so a reply is matched in constant time and a stale or duplicate
+                 reply for a reused slot is caught. IDs are 64 bits wide so the sequence number never wraps.
+
+                 All functions return 0 on success and -1 on failure with errno set, the same as the channel's.
+                 A reply which matches no request in flight fails with EPROTO.
+*/
+
+#ifndef RPC_H
+#define RPC_H
+
+#include <stdbool.h>
+
+#include "../channel/ipc_channel.h"
+
+#define RPC_SLOT_BITS   8
+#define RPC_MAX_WINDOW  (1U << RPC_SLOT_BITS)
+#define RPC_MAX_REORDER 16      //most requests rpc_serve() holds back to answer out of order
+
+//Structure of the data which is communicated between the parent and the child.
+typedef struct payload
+{
+  char string[16];
+  bool led_state;
+} payload_t;
+
+//What actually travels over the channel. The ID of a reply is the ID of the request it answers.
+typedef struct rpc_frame
+{
+  unsigned long long int id;
+  payload_t payload;
+} rpc_frame_t;
+
+//A request which has been sent and not answered yet.
+typedef struct rpc_pending
+{
+  bool busy;
+  unsigned long long int id;
+  unsigned long long int sent_ns;
+  payload_t request;
+} rpc_pending_t;
+
+//Called with every reply the client receives and the request it answers.
+typedef void (*rpc_reply_handler_t)(void *, const payload_t *, const payload_t *);
+
+//Called by the server with every request, which it turns into the reply in place.
+typedef void (*rpc_request_handler_t)(void *, payload_t *);
+
+typedef struct rpc_client
+{
+  channel_t *ch;
+  unsigned int window;
+  unsigned int in_flight;
+  unsigned long long int next_seq;
+  unsigned long long int highest_seq;   //highest sequence number answered so far
+  unsigned int free_slots[RPC_MAX_WINDOW];
+  unsigned int nfree;
+  rpc_pending_t pending[RPC_MAX_WINDOW];
+
+  rpc_reply_handler_t on_reply;
+  void *on_reply_context;
+
+  unsigned long long int completed;
+  unsigned long long int out_of_order;
+  unsigned long long int latency_ns;
+} rpc_client_t;
+
+int rpc_client_init(rpc_client_t *, channel_t *, unsigned int, rpc_reply_handler_t, void *);
+int rpc_submit(rpc_client_t *, const payload_t *, unsigned long long int *);
+int rpc_complete_one(rpc_client_t *);
+int rpc_drain(rpc_client_t *);
+int rpc_serve(channel_t *, unsigned int, unsigned int, rpc_request_handler_t, void *);
+
+#endif
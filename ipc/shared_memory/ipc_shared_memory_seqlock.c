@@ -0,0 +1,250 @@
+/*  Author: agent <agent@local>
+    Date: 19-October-2026
+    Description: A program to demonstrate a seqlock protected "latest value" slot in POSIX Shared Memory.
+                 ipc_shared_memory.c hands the payload back and forth with a semaphore, which is the right thing
+                 for a request and its reply but not for current state such as the LED state, where a reader only
+                 ever wants the newest value. Here the parent is the single writer and publishes updates without
+                 taking any lock, and any number of child readers take consistent snapshots, retrying when a write
+                 was in progress. Readers never block the writer.
+
+                 The slot keeps a sequence number which is odd while a write is in progress. A reader copies the
+                 payload between two loads of the sequence number and keeps the copy only if both loads saw the same
+                 even value. The payload is copied as words with relaxed atomics, so there is no data race between
+                 the writer and a reader whose snapshot is about to be thrown away. A reader which finds a write in
+                 progress pauses, and yields the CPU if the write takes long (the writer may be waiting for it),
+                 instead of spinning flat out; only snapshots thrown away count as retries.
+
+    To Build:    gcc -O2 -o ipc_shared_memory_seqlock ipc_shared_memory_seqlock.c -lrt
+    To Run:      ./ipc_shared_memory_seqlock [readers] [updates]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <time.h>
+#include <sched.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define cpu_relax()   _mm_pause()
+#else
+#define cpu_relax()
+#endif
+
+#define MAX_READERS   16
+#define SPIN_LIMIT    128     //polls of a write in progress before yielding the CPU
+#define SLOT_WORDS    ((sizeof(payload_t) + sizeof(unsigned long) - 1) / sizeof(unsigned long))
+
+//Structure of the data which is communicated between the parent and the child using shared memory.
+typedef struct payload
+{
+  char string[16];
+  bool led_state;
+} payload_t;
+
+//The shared memory layout: one seqlock protected payload and a flag telling readers the writer is done.
+typedef struct seqlock_slot
+{
+  _Atomic unsigned long sequence;
+  _Atomic unsigned long data[SLOT_WORDS];
+  _Atomic bool done;
+} seqlock_slot_t;
+
+void errExit(char *);
+void seqlock_write(seqlock_slot_t *, const payload_t *);
+unsigned long seqlock_read(seqlock_slot_t *, payload_t *, unsigned long long int *);
+void writer_wait(unsigned int *);
+unsigned long long int now_ns(void);
+
+int main(int argc, char *argv[])
+{
+  pid_t Child_Pid = 0;
+  int shm;
+  seqlock_slot_t *slot;
+  payload_t data;
+  unsigned int readers = 4, updates = 1000000, i, value = 0;
+  int status;
+  unsigned long version, last_version = 0;
+  unsigned long long int reads = 0, retries = 0, versions_seen = 0, start, elapsed;
+  char expected[16];
+
+  if(argc > 1)
+    readers = (unsigned int) atoi(argv[1]);
+  if(argc > 2)
+    updates = (unsigned int) atoi(argv[2]);
+  if(readers > MAX_READERS)
+    readers = MAX_READERS;
+
+  shm_unlink("seqlock_shared_memory");
+  shm = shm_open("seqlock_shared_memory", O_CREAT | O_RDWR, S_IRUSR | S_IWUSR);
+  if(shm == -1)
+    errExit("creation of shared memory descriptor");
+
+  if(ftruncate(shm, sizeof(seqlock_slot_t)) == -1)
+    errExit("fruncate");
+
+  slot = mmap(NULL, sizeof(seqlock_slot_t), PROT_READ | PROT_WRITE, MAP_SHARED, shm, 0);
+  if(slot == MAP_FAILED)
+    errExit("mmap");
+
+  //publish the initial state before any reader exists
+  bzero(&data, sizeof(payload_t));
+  strcpy(data.string, "Hello 0");
+  data.led_state = false;
+  seqlock_write(slot, &data);
+
+  printf("## PARENT ## Created shared descriptor, set its size to %lu bytes. Forking %u readers.\n", sizeof(seqlock_slot_t), readers);
+  fflush(stdout);     //or the children would print it again
+
+  for(i = 0; i < readers; i++)
+  {
+    switch (Child_Pid = fork())
+    {
+      case -1: /* fork() failed */
+        errExit("fork");
+        break;
+
+      case 0: /* Child of successful fork() comes here */
+        //the mapping is inherited, so the reader only has to poll the slot until the writer is done
+        while(!atomic_load_explicit(&slot->done, memory_order_acquire))
+        {
+          version = seqlock_read(slot, &data, &retries);
+          reads++;
+
+          //a torn snapshot would pair a string from one update with the LED state of another
+          sscanf(data.string, "Hello %u", &value);
+          snprintf(expected, sizeof(expected), "Hello %u", value);
+          if(strcmp(expected, data.string) || data.led_state != (bool) (value & 1))
+          {
+            fprintf(stderr, "## CHILD %u ## Inconsistent snapshot: \"%s\" with LED State %s.\n", i, data.string, data.led_state ? "true" : "false");
+            _exit(EXIT_FAILURE);
+          }
+
+          if(version != last_version)
+          {
+            versions_seen++;
+            last_version = version;
+          }
+        }
+
+        printf("## CHILD %u ## Reads: %llu | Retries: %llu | Distinct versions seen: %llu | Last string: \"%s\". Last LED State: %s.\n",
+               i, reads, retries, versions_seen, data.string, data.led_state ? "true" : "false");
+        fflush(stdout);
+        munmap(slot, sizeof(seqlock_slot_t));
+        close(shm);
+        _exit(EXIT_SUCCESS);
+
+      default: /* Parent comes here after successful fork() */
+        break;
+    }
+  }
+
+  //the parent is the only writer and never waits for the readers
+  start = now_ns();
+  for(value = 1; value <= updates; value++)
+  {
+    snprintf(data.string, sizeof(data.string), "Hello %u", value);
+    data.led_state = value & 1;
+    seqlock_write(slot, &data);
+  }
+  elapsed = now_ns() - start;
+  atomic_store_explicit(&slot->done, true, memory_order_release);
+
+  printf("## PARENT ## Published %u updates in %.2f ms (%.0f updates/s) without blocking.\n", updates, elapsed / 1e6, updates * 1e9 / elapsed);
+
+  for(i = 0; i < readers; i++)
+  {
+    if(wait(&status) == -1 || !WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS)
+      errExit("reader");
+  }
+
+  munmap(slot, sizeof(seqlock_slot_t));
+  close(shm);
+  shm_unlink("seqlock_shared_memory");
+  printf("## PARENT ## Communication successful. Closed and unlinked shared memory.\n");
+
+  exit(EXIT_SUCCESS);
+}
+
+//Publishes a new value. Only one process may write a slot.
+void seqlock_write(seqlock_slot_t *slot, const payload_t *data)
+{
+  unsigned long words[SLOT_WORDS] = { 0 };
+  unsigned long sequence = atomic_load_explicit(&slot->sequence, memory_order_relaxed);
+  unsigned int i;
+
+  memcpy(words, data, sizeof(payload_t));
+
+  //odd sequence: write in progress. The fence keeps the data stores from moving above it.
+  atomic_store_explicit(&slot->sequence, sequence + 1, memory_order_relaxed);
+  atomic_thread_fence(memory_order_release);
+
+  for(i = 0; i < SLOT_WORDS; i++)
+    atomic_store_explicit(&slot->data[i], words[i], memory_order_relaxed);
+
+  atomic_store_explicit(&slot->sequence, sequence + 2, memory_order_release);
+}
+
+//Takes a consistent snapshot of the slot, retrying while it races a write. Returns the snapshot's version.
+unsigned long seqlock_read(seqlock_slot_t *slot, payload_t *data, unsigned long long int *retries)
+{
+  unsigned long words[SLOT_WORDS];
+  unsigned long before, after;
+  unsigned int i, spins = 0;
+
+  while(1)
+  {
+    before = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+    if(before & 1)
+    {
+      writer_wait(&spins);
+      continue;
+    }
+
+    for(i = 0; i < SLOT_WORDS; i++)
+      words[i] = atomic_load_explicit(&slot->data[i], memory_order_relaxed);
+
+    //keeps the data loads from moving below the second load of the sequence number
+    atomic_thread_fence(memory_order_acquire);
+    after = atomic_load_explicit(&slot->sequence, memory_order_relaxed);
+
+    if(before == after)
+      break;
+    (*retries)++;
+  }
+
+  memcpy(data, words, sizeof(payload_t));
+  return before / 2;
+}
+
+//Waits a little for a write in progress, the same way ring_wait() in ../channel waits for a ring.
+void writer_wait(unsigned int *spins)
+{
+  if(++(*spins) > SPIN_LIMIT)
+    sched_yield();
+  else
+    cpu_relax();
+}
+
+unsigned long long int now_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (unsigned long long int) ts.tv_sec * 1000000000ULL + (unsigned long long int) ts.tv_nsec;
+}
+
+//Function to print the error to STDOUT and exit.
+void errExit(char *strError)
+{
+  perror(strError);
+  exit(EXIT_FAILURE);
+}
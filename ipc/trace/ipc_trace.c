@@ -0,0 +1,210 @@
+/*  Author: agent <agent@local>
+    Date: 19-October-2026
+    Description: Implementation of the memory mapped trace declared in ipc_trace.h.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <string.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <errno.h>
+
+#include "ipc_trace.h"
+#include "../channel/ipc_channel.h"
+
+#define TRACE_HEADER_SIZE   ((sizeof(trace_header_t) + TRACE_ALIGN - 1) & ~(size_t) (TRACE_ALIGN - 1))
+
+static unsigned long long int now_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (unsigned long long int) ts.tv_sec * 1000000000ULL + (unsigned long long int) ts.tv_nsec;
+}
+
+static size_t record_size(unsigned int length)
+{
+  return (sizeof(trace_record_t) + length + TRACE_ALIGN - 1) & ~(size_t) (TRACE_ALIGN - 1);
+}
+
+//Creates (or truncates) a trace file able to hold capacity bytes of records and maps it shared.
+int trace_create(trace_t *trace, const char *path, size_t capacity)
+{
+  bzero(trace, sizeof(trace_t));
+  trace->map_size = TRACE_HEADER_SIZE + capacity;
+
+  if((trace->fd = open(path, O_CREAT | O_TRUNC | O_RDWR, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH)) == -1)
+    return -1;
+
+  //the file stays sparse until records are written into it
+  if(ftruncate(trace->fd, (off_t) trace->map_size) == -1)
+    return -1;
+
+  trace->header = mmap(NULL, trace->map_size, PROT_READ | PROT_WRITE, MAP_SHARED, trace->fd, 0);
+  if(trace->header == MAP_FAILED)
+    return -1;
+  trace->records = (unsigned char *) trace->header + TRACE_HEADER_SIZE;
+
+  memcpy(trace->header->magic, TRACE_MAGIC, sizeof(trace->header->magic));
+  trace->header->version = TRACE_VERSION;
+  trace->header->header_size = TRACE_HEADER_SIZE;
+  trace->header->capacity = capacity;
+  trace->header->start_ns = now_ns();
+  atomic_init(&trace->header->tail, 0);
+  atomic_init(&trace->header->dropped, 0);
+  trace->writer = true;
+  return 0;
+}
+
+//Maps an existing trace read only, for replaying it.
+int trace_open(trace_t *trace, const char *path)
+{
+  struct stat st;
+
+  bzero(trace, sizeof(trace_t));
+
+  if((trace->fd = open(path, O_RDONLY)) == -1)
+    return -1;
+
+  if(fstat(trace->fd, &st) == -1)
+    return -1;
+
+  if((size_t) st.st_size < TRACE_HEADER_SIZE)
+  {
+    errno = EINVAL;
+    return -1;
+  }
+  trace->map_size = (size_t) st.st_size;
+
+  trace->header = mmap(NULL, trace->map_size, PROT_READ, MAP_SHARED, trace->fd, 0);
+  if(trace->header == MAP_FAILED)
+    return -1;
+
+  //a trace cut short (or a corrupt header) must not claim records beyond the end of the file
+  if(memcmp(trace->header->magic, TRACE_MAGIC, sizeof(trace->header->magic)) || trace->header->version != TRACE_VERSION ||
+     trace->header->header_size < TRACE_HEADER_SIZE || trace->header->header_size % TRACE_ALIGN ||
+     trace->header->header_size > trace->map_size || trace->header->capacity > trace->map_size - trace->header->header_size)
+  {
+    errno = EINVAL;
+    return -1;
+  }
+  trace->records = (unsigned char *) trace->header + trace->header->header_size;
+  return 0;
+}
+
+/* Appends n frames of length bytes each, laid out back to back in frames, as records sharing one timestamp.
+   Space for all of them is reserved with a single atomic add. Returns -1 with ENOSPC if they do not fit.
+
+   The size of every record is written before any frame is copied, so a reader can step over the whole batch
+   even if the writer dies halfway through it. The timestamp is taken after the reservation, which keeps
+   timestamps close to record order, though two writers racing for the tail can still swap them. */
+int trace_append(trace_t *trace, unsigned short transport, unsigned char direction, const void *frames, unsigned int length, unsigned int n)
+{
+  size_t size = record_size(length);
+  unsigned long long int offset, timestamp;
+  trace_record_t *record;
+  unsigned int i;
+
+  offset = atomic_fetch_add_explicit(&trace->header->tail, size * n, memory_order_relaxed);
+  if(offset + size * n > trace->header->capacity)
+  {
+    atomic_fetch_add_explicit(&trace->header->dropped, n, memory_order_relaxed);
+    errno = ENOSPC;
+    return -1;
+  }
+
+  for(i = 0; i < n; i++)
+    ((trace_record_t *) (trace->records + offset + i * size))->size = (unsigned int) size;
+
+  timestamp = now_ns();
+  for(i = 0; i < n; i++, offset += size)
+  {
+    record = (trace_record_t *) (trace->records + offset);
+    record->timestamp_ns = timestamp;
+    record->transport = transport;
+    record->direction = direction;
+    record->reserved = 0;
+    record->length = length;
+    memcpy(record->data, (const unsigned char *) frames + (size_t) i * length, length);
+    atomic_store_explicit(&record->committed, 1, memory_order_release);
+  }
+  return 0;
+}
+
+/* Returns the record after prev, or the first record when prev is NULL. Records which were reserved but never
+   committed (their writer died) are skipped. NULL marks the end of the trace, and also a record whose size or
+   length would run past the records area (or whose direction is unknown), so a corrupt trace is never read
+   out of bounds. */
+const trace_record_t *trace_next(const trace_t *trace, const trace_record_t *prev)
+{
+  const trace_record_t *record;
+  unsigned long long int offset, tail;
+
+  tail = atomic_load_explicit(&trace->header->tail, memory_order_acquire);
+  if(tail > trace->header->capacity)
+    tail = trace->header->capacity;
+
+  //prev came from this function, so its size has already been checked
+  offset = prev ? (unsigned long long int) ((const unsigned char *) prev - trace->records) + prev->size : 0;
+
+  while(offset + sizeof(trace_record_t) <= tail)
+  {
+    record = (const trace_record_t *) (trace->records + offset);
+    if(record->size < sizeof(trace_record_t) || record->size % TRACE_ALIGN || offset + record->size > tail)
+      return NULL;
+
+    if(atomic_load_explicit(&((trace_record_t *) record)->committed, memory_order_acquire))
+    {
+      if(record->length > record->size - sizeof(trace_record_t) || record->direction > TRACE_CHILD_TO_PARENT)
+        return NULL;
+      return record;
+    }
+    offset += record->size;
+  }
+  return NULL;
+}
+
+/* Unmaps the trace. The process which created it also trims the file down to the records written, so the
+   capacity reserved up front does not stay on disk; it must therefore be the last one writing to the trace. */
+int trace_close(trace_t *trace)
+{
+  unsigned long long int used = 0;
+  int status = 0;
+
+  if(trace->header != NULL && trace->header != MAP_FAILED)
+  {
+    if(trace->writer)
+    {
+      used = atomic_load_explicit(&trace->header->tail, memory_order_acquire);
+      if(used > trace->header->capacity)
+        used = trace->header->capacity;
+      //the header has to agree with the shorter file, or trace_open() would reject it
+      trace->header->capacity = used;
+      atomic_store_explicit(&trace->header->tail, used, memory_order_relaxed);
+      used += trace->header->header_size;
+    }
+    munmap(trace->header, trace->map_size);
+  }
+  if(trace->fd != -1)
+  {
+    if(trace->writer && ftruncate(trace->fd, (off_t) used) == -1)
+      status = -1;
+    close(trace->fd);
+  }
+  trace->header = NULL;
+  trace->fd = -1;
+  return status;
+}
+
+//Channel send hook: records every frame a channel sends. Install with channel_set_send_hook(ch, trace_channel_hook, trace).
+void trace_channel_hook(void *context, const struct channel *ch, const void *frames, unsigned int n)
+{
+  trace_append((trace_t *) context, (unsigned short) ch->transport,
+               ch->side == CHANNEL_PARENT ? TRACE_PARENT_TO_CHILD : TRACE_CHILD_TO_PARENT,
+               frames, (unsigned int) ch->frame_size, n);
+}
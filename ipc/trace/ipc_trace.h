@@ -0,0 +1,71 @@
+/*  Author: agent <agent@local>
+    Date: 19-October-2026
+    Description: Binary trace of IPC traffic, kept in a memory mapped, append only file.
+                 The file is created at a fixed capacity before fork() and mapped shared, so the parent and the
+                 child append to the same log. Appending costs one atomic add on the file's tail to reserve space,
+                 a copy of the frame and one release store to commit the record; there are no system calls and no
+                 locks. A record which does not fit is dropped and counted instead of growing the file, and the
+                 creator trims the file to what was recorded when it closes the trace.
+
+                 Each record holds the time it was sent, its direction, the transport it went over and a copy of
+                 the frame. Records appear in the order they were sent, which ipc_trace_replay relies on to drive
+                 the same traffic again.
+*/
+
+#ifndef IPC_TRACE_H
+#define IPC_TRACE_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+#define TRACE_MAGIC           "IPCTRACE"
+#define TRACE_VERSION         1
+#define TRACE_ALIGN           8
+
+#define TRACE_PARENT_TO_CHILD 0
+#define TRACE_CHILD_TO_PARENT 1
+
+typedef struct trace_header
+{
+  char magic[8];
+  unsigned int version;
+  unsigned int header_size;
+  unsigned long long int capacity;          //bytes available for records after the header
+  unsigned long long int start_ns;          //CLOCK_MONOTONIC when the trace was created
+  _Atomic unsigned long long int tail;      //bytes reserved for records so far
+  _Atomic unsigned long long int dropped;   //records which did not fit
+} trace_header_t;
+
+typedef struct trace_record
+{
+  unsigned int size;                        //whole record including padding, written as soon as space is reserved
+  _Atomic unsigned int committed;           //set once the record is complete
+  unsigned long long int timestamp_ns;
+  unsigned short transport;                 //a channel_transport_t
+  unsigned char direction;                  //TRACE_PARENT_TO_CHILD or TRACE_CHILD_TO_PARENT
+  unsigned char reserved;
+  unsigned int length;                      //bytes of frame data
+  unsigned char data[];
+} trace_record_t;
+
+typedef struct trace
+{
+  int fd;
+  size_t map_size;
+  trace_header_t *header;
+  unsigned char *records;
+  bool writer;                              //created by this process, which trims the file on trace_close()
+} trace_t;
+
+struct channel;
+
+int trace_create(trace_t *, const char *, size_t);
+int trace_open(trace_t *, const char *);
+int trace_append(trace_t *, unsigned short, unsigned char, const void *, unsigned int, unsigned int);
+const trace_record_t *trace_next(const trace_t *, const trace_record_t *);
+int trace_close(trace_t *);
+
+void trace_channel_hook(void *, const struct channel *, const void *, unsigned int);
+
+#endif
@@ -0,0 +1,231 @@
+/*  Author: agent <agent@local>
+    Date: 19-October-2026
+    Description: A program to replay an IPC trace recorded with ipc_trace.c through any of the channel transports.
+                 The parent and a forked child walk the trace in the order it was recorded. Each side sends the
+                 frames it sent originally, paced to their original timestamps divided by the speed factor, and
+                 receives the frames its peer sent, checking them byte for byte against the trace. Walking one
+                 shared order means every receive happens after its send, just as it did when it was recorded.
+
+                 A speed of 1 replays at the original pace, 10 ten times faster, and 0 as fast as the transport
+                 allows.
+
+    To Build:    gcc -O2 -o ipc_trace_replay ipc_trace_replay.c ipc_trace.c ../channel/ipc_channel.c ../channel/crc32c.c -lrt
+    To Run:      ./ipc_trace_replay <trace file> [recorded|pipe|socket|mqueue|shm] [speed]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <stdbool.h>
+
+#include "ipc_trace.h"
+#include "../channel/ipc_channel.h"
+
+#define SLEEP_THRESHOLD_NS  100000ULL     //gaps longer than this are slept through, shorter ones are spun
+#define MAX_FRAME_SIZE      65536U        //larger records come from a corrupt trace, not from a channel
+
+void errExit(char *);
+unsigned long long int replay(trace_t *, channel_t *, unsigned char, double, unsigned long long int *);
+void wait_until(unsigned long long int);
+unsigned long long int now_ns(void);
+
+int main(int argc, char *argv[])
+{
+  pid_t Child_Pid = 0;
+  trace_t trace;
+  channel_t ch;
+  channel_transport_t transport = CHANNEL_PIPE;
+  const trace_record_t *record;
+  unsigned long long int records = 0, first_ns = 0, last_ns = 0, mismatches = 0, start, elapsed;
+  unsigned int frame_size = 0;
+  unsigned int run = 0, longest_run = 0;
+  unsigned char run_direction = 0;
+  double speed = 1.0;
+  char pace[32];
+  int status;
+
+  if(argc < 2)
+  {
+    fprintf(stderr, "Usage: %s <trace file> [recorded|pipe|socket|mqueue|shm] [speed]\n", argv[0]);
+    exit(EXIT_FAILURE);
+  }
+
+  if(trace_open(&trace, argv[1]) == -1)
+    errExit("trace_open");
+
+  //one pass for the frame size, the time span and the longest run of frames sent in one direction
+  for(record = trace_next(&trace, NULL); record != NULL; record = trace_next(&trace, record))
+  {
+    if(records++ == 0)
+    {
+      first_ns = last_ns = record->timestamp_ns;
+      transport = (channel_transport_t) record->transport;
+    }
+    //timestamps are only nearly in record order, see trace_append()
+    if(record->timestamp_ns < first_ns)
+      first_ns = record->timestamp_ns;
+    if(record->timestamp_ns > last_ns)
+      last_ns = record->timestamp_ns;
+    if(record->length > frame_size)
+      frame_size = record->length;
+
+    run = (record->direction == run_direction) ? run + 1 : 1;
+    run_direction = record->direction;
+    if(run > longest_run)
+      longest_run = run;
+  }
+
+  if(records == 0)
+  {
+    fprintf(stderr, "## REPLAY ## \"%s\" holds no records.\n", argv[1]);
+    exit(EXIT_FAILURE);
+  }
+  if(frame_size > MAX_FRAME_SIZE)
+  {
+    fprintf(stderr, "## REPLAY ## \"%s\" holds a %u byte record, more than the %u bytes a frame may have.\n",
+            argv[1], frame_size, MAX_FRAME_SIZE);
+    exit(EXIT_FAILURE);
+  }
+
+  if(argc > 2 && strcmp(argv[2], "recorded") && channel_transport_parse(argv[2], &transport) == -1)
+    errExit("unknown transport");
+  if(argc > 3)
+    speed = atof(argv[3]);
+
+  if(speed > 0)
+    snprintf(pace, sizeof(pace), "%gx the original pace", speed);
+  else
+    strcpy(pace, "full speed");
+
+  printf("## REPLAY ## %llu records (%llu dropped while recording) of %u bytes spanning %.2f ms. Replaying over %s at %s.\n",
+         records, (unsigned long long int) atomic_load(&trace.header->dropped), frame_size, (last_ns - first_ns) / 1e6,
+         channel_transport_name(transport), pace);
+  fflush(stdout);     //or the child would print it again
+
+  /* A side can only get ahead of its peer by the frames it sends before its next receive, so a channel as deep
+     as the longest run never makes the sender wait. A shallower one (message queues) is slower but cannot
+     deadlock, because the peer walks the same order and drains the run as it goes. */
+  if(channel_create(&ch, transport, frame_size, longest_run < 256 ? longest_run : 256) == -1)
+    errExit("channel_create");
+
+  switch (Child_Pid = fork())
+  {
+    case -1: /* fork() failed */
+      errExit("fork");
+      break;
+
+    case 0: /* Child of successful fork() comes here */
+      if(channel_attach(&ch, CHANNEL_CHILD) == -1)
+        errExit("child channel_attach");
+
+      replay(&trace, &ch, TRACE_CHILD_TO_PARENT, speed, &mismatches);
+
+      channel_close(&ch);
+      trace_close(&trace);
+      _exit(mismatches ? EXIT_FAILURE : EXIT_SUCCESS);
+
+    default: /* Parent comes here after successful fork() */
+      if(channel_attach(&ch, CHANNEL_PARENT) == -1)
+        errExit("parent channel_attach");
+
+      start = now_ns();
+      replay(&trace, &ch, TRACE_PARENT_TO_CHILD, speed, &mismatches);
+
+      if(waitpid(Child_Pid, &status, 0) == -1)
+        errExit("waitpid");
+      elapsed = now_ns() - start;
+
+      printf("## REPLAY ## Replayed %llu frames in %.2f ms (%.0f frames/s). Frames differing from the trace: parent %llu, child %s.\n",
+             records, elapsed / 1e6, records * 1e9 / elapsed, mismatches,
+             WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS ? "0" : "some");
+
+      channel_close(&ch);
+      trace_close(&trace);
+
+      if(mismatches || !WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS)
+        exit(EXIT_FAILURE);
+      break;
+  }
+
+  exit(EXIT_SUCCESS);
+}
+
+//Sends this side's records and receives the peer's. Returns the number of frames sent.
+unsigned long long int replay(trace_t *trace, channel_t *ch, unsigned char direction, double speed, unsigned long long int *mismatches)
+{
+  const trace_record_t *record;
+  unsigned char *frame;
+  unsigned long long int first_ns = 0, offset_ns = 0, start = now_ns(), sent = 0;
+
+  if((frame = malloc(ch->frame_size)) == NULL)
+    errExit("malloc");
+
+  if((record = trace_next(trace, NULL)) != NULL)
+    first_ns = record->timestamp_ns;
+
+  for(; record != NULL; record = trace_next(trace, record))
+  {
+    /* Timestamps can step backwards where two writers raced for the tail (see trace_append()). The offset
+       only ever grows, so such a record is sent straight away instead of wrapping the subtraction. */
+    if(record->timestamp_ns > first_ns + offset_ns)
+      offset_ns = record->timestamp_ns - first_ns;
+
+    if(record->direction == direction)
+    {
+      if(speed > 0)
+        wait_until(start + (unsigned long long int) (offset_ns / speed));
+
+      bzero(frame, ch->frame_size);
+      memcpy(frame, record->data, record->length);
+      if(channel_send(ch, frame) == -1)
+        errExit("replay send");
+      sent++;
+    }
+    else
+    {
+      if(channel_recv(ch, frame) == -1)
+        errExit("replay receive");
+      if(memcmp(frame, record->data, record->length))
+        (*mismatches)++;
+    }
+  }
+
+  free(frame);
+  return sent;
+}
+
+void wait_until(unsigned long long int deadline)
+{
+  struct timespec ts;
+  unsigned long long int now = now_ns();
+
+  if(deadline > now + SLEEP_THRESHOLD_NS)
+  {
+    deadline -= SLEEP_THRESHOLD_NS / 2;     //wake a little early and spin the rest
+    ts.tv_sec = (time_t) (deadline / 1000000000ULL);
+    ts.tv_nsec = (long) (deadline % 1000000000ULL);
+    clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+    deadline += SLEEP_THRESHOLD_NS / 2;
+  }
+  while(now_ns() < deadline)
+    ;
+}
+
+unsigned long long int now_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (unsigned long long int) ts.tv_sec * 1000000000ULL + (unsigned long long int) ts.tv_nsec;
+}
+
+//Function to print the error to STDOUT and exit.
+void errExit(char *strError)
+{
+  perror(strError);
+  exit(EXIT_FAILURE);
+}
@@ -0,0 +1,611 @@
+/*  Author: agent <agent@local>
+    Date: 19-October-2026
+    Description: A userspace counterpart to the klineage and kfifo_queue kernel modules which needs neither
+                 root nor insmod. Everything is read from /proc/<pid>/stat and /proc/<pid>/sched.
+                 ○ lineage: walks the process tree from a PID back up to init, printing the same metrics
+                            as klineage (name, PID, state, number of children, priority, nice value).
+                 ○ sample:  samples every task (every thread of every process) on the system at a fixed
+                            interval and prints the PID / VRUNTIME / PRIORITY / NICE records that kfifo_queue
+                            logs. Passes are timed against a running deadline, so the time a pass takes does
+                            not add to the interval. /proc is rescanned for new tasks about once a second.
+                 ○ bench:   forks a growing number of idle tasks and reports samples per second
+                            against the number of tasks being sampled.
+
+                 A sampling pass does not allocate. Every tracked task keeps its two /proc descriptors open
+                 and is re-read with pread() at offset 0, the parsers work in place on a fixed stack buffer,
+                 and one pass fills a preallocated record array which is only printed once the whole batch
+                 has been read. Only the rescans walk /proc with opendir(), which allocates, which is why they
+                 are made once a second rather than before every pass. Two descriptors per task add up, so
+                 the soft limit on open files is raised to the hard limit at startup, and tasks which still
+                 cannot be opened are reported rather than silently left out.
+
+    To Build:    gcc -O2 -o proc_sampler proc_sampler.c
+    To Run:      ./proc_sampler lineage [pid]
+                 ./proc_sampler sample [interval_ms] [count]
+                 ./proc_sampler bench [max_tasks] [duration_ms]
+*/
+
+#define _GNU_SOURCE     //memmem()
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <stdbool.h>
+#include <sys/resource.h>
+
+#define MAX_TASKS       4096
+#define PID_HASH_SIZE   (2 * MAX_TASKS)     //open addressing table of tracked PIDs, at most half full
+#define STAT_BUF_SIZE   512
+#define SCHED_BUF_SIZE  4096
+#define MAX_RT_PRIO     100     //the stat "priority" field is task->prio - MAX_RT_PRIO
+#define RESCAN_MS       1000    //how often the sample command looks for new tasks in /proc
+
+//Record produced for every task on every sampling pass, matching what kfifo_queue and klineage report.
+typedef struct sample
+{
+  pid_t pid;
+  pid_t ppid;
+  char state;
+  int prio;
+  int nice;
+  unsigned long long int vruntime;    //nanoseconds, as in task->se.vruntime
+  char comm[16];
+} sample_t;
+
+//A tracked task. Both descriptors stay open for the lifetime of the sampler.
+typedef struct task
+{
+  pid_t pid;
+  int stat_fd;
+  int sched_fd;     //-1 when the kernel is built without CONFIG_SCHED_DEBUG
+  bool alive;
+} task_t;
+
+typedef struct sampler
+{
+  task_t tasks[MAX_TASKS];
+  sample_t records[MAX_TASKS];
+  unsigned int ntasks;
+  int index[PID_HASH_SIZE];         //1 + slot in tasks[] of a PID, 0 for an empty bucket
+  unsigned int dropped;             //tasks the last scan found but could not track
+  int drop_reason;                  //errno of the last of them
+} sampler_t;
+
+void errExit(char *);
+int task_open(task_t *, pid_t);
+void task_close(task_t *);
+int sampler_add(sampler_t *, pid_t);
+bool sampler_tracks(sampler_t *, pid_t);
+unsigned int sampler_scan(sampler_t *, bool);
+unsigned int sampler_pass(sampler_t *);
+void sampler_close(sampler_t *);
+int read_sample(task_t *, sample_t *);
+int parse_stat(const char *, ssize_t, sample_t *);
+unsigned long long int parse_vruntime(const char *, ssize_t);
+void print_lineage(pid_t);
+void print_samples(sampler_t *, unsigned int);
+void run_bench(unsigned int, unsigned int);
+void kill_children(void);
+rlim_t raise_fd_limit(void);
+void sleep_until(unsigned long long int);
+unsigned long long int now_ns(void);
+
+static sampler_t sampler;     //large, so kept off the stack
+
+//idle children forked by the benchmark, killed by kill_children() however the program exits
+static pid_t children[MAX_TASKS];
+static unsigned int nchildren;
+
+int main(int argc, char *argv[])
+{
+  unsigned int interval_ms = 1000, count = 0, pass = 0, rescan_every, nrecords;
+  unsigned long long int deadline, interval_ns;
+
+  raise_fd_limit();
+
+  if(argc < 2 || !strcmp(argv[1], "lineage"))
+  {
+    print_lineage(argc > 2 ? (pid_t) atoi(argv[2]) : getpid());
+  }
+  else if(!strcmp(argv[1], "sample"))
+  {
+    if(argc > 2)
+      interval_ms = (unsigned int) atoi(argv[2]);
+    if(argc > 3)
+      count = (unsigned int) atoi(argv[3]);
+
+    printf("## SAMPLER ## Sampling every task every %u ms.\n", interval_ms);
+
+    rescan_every = interval_ms && interval_ms < RESCAN_MS ? RESCAN_MS / interval_ms : 1;
+    interval_ns = interval_ms * 1000000ULL;
+    deadline = now_ns();
+
+    while(count == 0 || pass < count)
+    {
+      if(pass % rescan_every == 0)
+        sampler_scan(&sampler, true);
+      nrecords = sampler_pass(&sampler);
+      printf("## SAMPLER ## --------------------------------------------------------------------------- ##\n");
+      if(sampler.dropped)
+        printf("## SAMPLER ## %u tasks could not be tracked (%s) and are missing from this pass.\n", sampler.dropped, strerror(sampler.drop_reason));
+      print_samples(&sampler, nrecords);
+      pass++;
+
+      //a pass which overran its interval starts the next one straight away rather than trying to catch up
+      deadline += interval_ns;
+      if(deadline < now_ns())
+        deadline = now_ns();
+      sleep_until(deadline);
+    }
+    sampler_close(&sampler);
+  }
+  else if(!strcmp(argv[1], "bench"))
+  {
+    run_bench(argc > 2 ? (unsigned int) atoi(argv[2]) : 1024, argc > 3 ? (unsigned int) atoi(argv[3]) : 1000);
+  }
+  else
+  {
+    fprintf(stderr, "Usage: %s lineage [pid] | sample [interval_ms] [count] | bench [max_tasks] [duration_ms]\n", argv[0]);
+    exit(EXIT_FAILURE);
+  }
+
+  exit(EXIT_SUCCESS);
+}
+
+//Opens the /proc descriptors of a task. Returns -1 if the task is already gone.
+int task_open(task_t *task, pid_t pid)
+{
+  char path[64];
+
+  task->pid = pid;
+
+  snprintf(path, sizeof(path), "/proc/%d/stat", (int) pid);
+  if((task->stat_fd = open(path, O_RDONLY | O_CLOEXEC)) == -1)
+    return -1;
+
+  snprintf(path, sizeof(path), "/proc/%d/sched", (int) pid);
+  task->sched_fd = open(path, O_RDONLY | O_CLOEXEC);
+
+  task->alive = true;
+  return 0;
+}
+
+void task_close(task_t *task)
+{
+  close(task->stat_fd);
+  if(task->sched_fd != -1)
+    close(task->sched_fd);
+  task->alive = false;
+}
+
+static unsigned int pid_hash(pid_t pid)
+{
+  return ((unsigned int) pid * 2654435761U) % PID_HASH_SIZE;
+}
+
+static void index_insert(sampler_t *s, pid_t pid, unsigned int slot)
+{
+  unsigned int h;
+
+  for(h = pid_hash(pid); s->index[h] != 0; h = (h + 1) % PID_HASH_SIZE)
+    ;
+  s->index[h] = (int) slot + 1;
+}
+
+bool sampler_tracks(sampler_t *s, pid_t pid)
+{
+  unsigned int h;
+
+  for(h = pid_hash(pid); s->index[h] != 0; h = (h + 1) % PID_HASH_SIZE)
+  {
+    if(s->tasks[s->index[h] - 1].pid == pid)
+      return true;
+  }
+  return false;
+}
+
+//Starts tracking a task. Returns -1 if the task is already gone, no descriptor is left or the sampler is full.
+int sampler_add(sampler_t *s, pid_t pid)
+{
+  if(s->ntasks == MAX_TASKS)
+  {
+    errno = ENOSPC;
+    return -1;
+  }
+
+  if(task_open(&s->tasks[s->ntasks], pid) == -1)
+    return -1;
+
+  index_insert(s, pid, s->ntasks);
+  s->ntasks++;
+  return 0;
+}
+
+/* Drops the tasks which have exited, then tracks every task in /proc which is not tracked yet, with all of
+   its threads if threads is set. Tasks which exist but cannot be opened are counted in s->dropped, with the
+   reason in s->drop_reason, and the count is returned. Tasks which exit during the scan are not counted. */
+unsigned int sampler_scan(sampler_t *s, bool threads)
+{
+  DIR *proc, *task_dir;
+  struct dirent *entry, *thread;
+  char path[64];
+  unsigned int i, kept = 0;
+  pid_t pid, tid;
+
+  for(i = 0; i < s->ntasks; i++)
+  {
+    if(s->tasks[i].alive)
+      s->tasks[kept++] = s->tasks[i];
+  }
+  s->ntasks = kept;
+  bzero(s->index, sizeof(s->index));
+  for(i = 0; i < s->ntasks; i++)
+    index_insert(s, s->tasks[i].pid, i);
+
+  s->dropped = 0;
+  s->drop_reason = 0;
+  if((proc = opendir("/proc")) == NULL)
+    errExit("opendir /proc");
+
+  while((entry = readdir(proc)) != NULL)
+  {
+    if((pid = (pid_t) atoi(entry->d_name)) <= 0)
+      continue;
+
+    if(!sampler_tracks(s, pid) && sampler_add(s, pid) == -1 && errno != ENOENT)
+    {
+      s->drop_reason = errno;
+      s->dropped++;
+    }
+    if(!threads)
+      continue;
+
+    snprintf(path, sizeof(path), "/proc/%d/task", (int) pid);
+    if((task_dir = opendir(path)) == NULL)
+    {
+      if(errno != ENOENT)
+      {
+        s->drop_reason = errno;
+        s->dropped++;
+      }
+      continue;
+    }
+    while((thread = readdir(task_dir)) != NULL)
+    {
+      if((tid = (pid_t) atoi(thread->d_name)) <= 0 || tid == pid || sampler_tracks(s, tid))
+        continue;
+      if(sampler_add(s, tid) == -1 && errno != ENOENT)
+      {
+        s->drop_reason = errno;
+        s->dropped++;
+      }
+    }
+    closedir(task_dir);
+  }
+  closedir(proc);
+
+  return s->dropped;
+}
+
+//Reads every live task back to back into the record array. Returns the number of records filled.
+unsigned int sampler_pass(sampler_t *s)
+{
+  unsigned int i, nrecords = 0;
+  task_t *task;
+
+  for(i = 0; i < s->ntasks; i++)
+  {
+    task = &s->tasks[i];
+    if(!task->alive)
+      continue;
+
+    if(read_sample(task, &s->records[nrecords]) == -1)
+    {
+      task_close(task);     //the task has exited since the last pass - stop tracking it
+      continue;
+    }
+    nrecords++;
+  }
+  return nrecords;
+}
+
+void sampler_close(sampler_t *s)
+{
+  unsigned int i;
+
+  for(i = 0; i < s->ntasks; i++)
+  {
+    if(s->tasks[i].alive)
+      task_close(&s->tasks[i]);
+  }
+  s->ntasks = 0;
+}
+
+//Re-reads both /proc files of a task through its open descriptors and parses them in place.
+int read_sample(task_t *task, sample_t *record)
+{
+  char buf[SCHED_BUF_SIZE];
+  ssize_t len;
+
+  if((len = pread(task->stat_fd, buf, STAT_BUF_SIZE, 0)) <= 0)
+    return -1;
+
+  if(parse_stat(buf, len, record) == -1)
+    return -1;
+
+  record->vruntime = 0;
+  if(task->sched_fd != -1)
+  {
+    if((len = pread(task->sched_fd, buf, sizeof(buf), 0)) <= 0)
+      return -1;
+    record->vruntime = parse_vruntime(buf, len);
+  }
+  return 0;
+}
+
+/* Parses /proc/<pid>/stat without copying or allocating:
+   pid (comm) state ppid pgrp session tty_nr tpgid flags minflt cminflt majflt cmajflt utime stime cutime cstime priority nice ...
+   comm may itself contain spaces and parentheses, so the fields are located from the last ')'. */
+int parse_stat(const char *buf, ssize_t len, sample_t *record)
+{
+  const char *p = buf, *end = buf + len, *open_paren, *close_paren = NULL;
+  long value;
+  bool negative;
+  int field;
+  size_t comm_len;
+
+  record->pid = 0;
+  while(p < end && *p >= '0' && *p <= '9')
+    record->pid = record->pid * 10 + (*p++ - '0');
+
+  if(p + 2 >= end || p[1] != '(')
+    return -1;
+  open_paren = p + 1;
+
+  for(p = end - 1; p > open_paren; p--)
+  {
+    if(*p == ')')
+    {
+      close_paren = p;
+      break;
+    }
+  }
+  if(close_paren == NULL || close_paren + 3 >= end)
+    return -1;
+
+  comm_len = (size_t) (close_paren - open_paren - 1);
+  if(comm_len >= sizeof(record->comm))
+    comm_len = sizeof(record->comm) - 1;
+  memcpy(record->comm, open_paren + 1, comm_len);
+  record->comm[comm_len] = '\0';
+
+  record->state = close_paren[2];
+  p = close_paren + 3;
+
+  //fields 4 (ppid) through 19 (nice) are all integers
+  for(field = 4; field <= 19 && p < end; field++)
+  {
+    while(p < end && *p == ' ')
+      p++;
+
+    negative = (p < end && *p == '-');
+    if(negative)
+      p++;
+
+    for(value = 0; p < end && *p >= '0' && *p <= '9'; p++)
+      value = value * 10 + (*p - '0');
+    if(negative)
+      value = -value;
+
+    if(field == 4)
+      record->ppid = (pid_t) value;
+    else if(field == 18)
+      record->prio = (int) value + MAX_RT_PRIO;
+    else if(field == 19)
+      record->nice = (int) value;
+  }
+  return field > 19 ? 0 : -1;
+}
+
+//Finds "se.vruntime : <ms>.<ns>" in /proc/<pid>/sched and returns it in nanoseconds.
+unsigned long long int parse_vruntime(const char *buf, ssize_t len)
+{
+  static const char key[] = "se.vruntime";
+  const char *p, *end = buf + len;
+  unsigned long long int ms = 0, ns = 0;
+  int digits = 0;
+
+  if((p = memmem(buf, (size_t) len, key, sizeof(key) - 1)) == NULL)
+    return 0;
+
+  for(p += sizeof(key) - 1; p < end && (*p == ' ' || *p == ':'); p++)
+    ;
+
+  for(; p < end && *p >= '0' && *p <= '9'; p++)
+    ms = ms * 10 + (unsigned long long int) (*p - '0');
+
+  if(p < end && *p == '.')
+  {
+    for(p++; p < end && *p >= '0' && *p <= '9' && digits < 6; p++, digits++)
+      ns = ns * 10 + (unsigned long long int) (*p - '0');
+  }
+  for(; digits < 6; digits++)
+    ns *= 10;
+
+  return ms * 1000000ULL + ns;
+}
+
+//Walks from a task back up to init, the same traversal klineage does through task->parent.
+void print_lineage(pid_t pid)
+{
+  task_t task;
+  sample_t record;
+  unsigned int i, nrecords, children;
+
+  printf("## LINEAGE ## Starting..\n");
+
+  //one pass over /proc gives the parent of every process, which is all that is needed to count children
+  if(sampler_scan(&sampler, false))
+    printf("## LINEAGE ## %u processes could not be read (%s), children counts may be short.\n", sampler.dropped, strerror(sampler.drop_reason));
+  nrecords = sampler_pass(&sampler);
+
+  while(pid != 0)
+  {
+    printf("## LINEAGE ## --------------------------------------------------------------------------------------------------------------------- ##\n");
+
+    if(task_open(&task, pid) == -1)
+      errExit("open /proc/<pid>/stat");
+
+    if(read_sample(&task, &record) == -1)
+      errExit("read /proc/<pid>/stat");
+    task_close(&task);
+
+    for(i = 0, children = 0; i < nrecords; i++)
+    {
+      if(sampler.records[i].ppid == pid)
+        children++;
+    }
+
+    printf("## LINEAGE ## CURRENT PROCESS: \"%s\" | PID: %d | STATE: %c ## CHILDREN: %u | PRIORITY: %d | NICE VALUE: %d |\n", record.comm, (int) record.pid, record.state, children, record.prio, record.nice);
+
+    pid = record.ppid;
+  }
+  printf("## LINEAGE ## --------------------------------------------------------------------------------------------------------------------- ##\n");
+  printf("## LINEAGE ## Exiting..\n");
+
+  sampler_close(&sampler);
+}
+
+void print_samples(sampler_t *s, unsigned int nrecords)
+{
+  unsigned int i;
+
+  for(i = 0; i < nrecords; i++)
+    printf("## SAMPLER ## TASK PID: %d | VRUNTIME: %llu | PRIORITY: %d | NICE VALUE: %d ##\n", (int) s->records[i].pid, s->records[i].vruntime, s->records[i].prio, s->records[i].nice);
+}
+
+/* Forks idle children in steps of powers of two up to max_tasks and samples them for duration_ms at
+   each step. A sample is one task read once, so samples/s divided by the task count is the rate at
+   which every task could be sampled. */
+void run_bench(unsigned int max_tasks, unsigned int duration_ms)
+{
+  unsigned int ntasks, passes, fit;
+  unsigned long long int start, elapsed, samples;
+  rlim_t limit = raise_fd_limit();
+  pid_t pid;
+
+  if(max_tasks > MAX_TASKS)
+    max_tasks = MAX_TASKS;
+
+  //two descriptors per task, and a few for stdio and the like
+  fit = limit > 32 ? (unsigned int) ((limit - 32) / 2) : 0;
+  if(max_tasks > fit)
+  {
+    printf("## BENCH ## Open file limit allows %u tasks, not %u.\n", fit, max_tasks);
+    max_tasks = fit;
+  }
+
+  //errExit() leaves through exit(), so the children are killed on failures as well
+  if(atexit(kill_children) != 0)
+    errExit("atexit");
+
+  printf("## BENCH ## %10s | %12s | %16s | %16s ##\n", "TASKS", "PASSES/S", "SAMPLES/S", "NS/SAMPLE");
+
+  for(ntasks = 1; ntasks <= max_tasks; ntasks *= 2)
+  {
+    while(nchildren < ntasks)
+    {
+      switch(pid = fork())
+      {
+        case -1:
+          errExit("fork");
+          break;
+
+        case 0:     //idle child, only there to be sampled
+          pause();
+          _exit(EXIT_SUCCESS);
+
+        default:
+          children[nchildren++] = pid;
+          if(sampler_add(&sampler, pid) == -1)
+            errExit("open /proc/<pid>/stat");
+          break;
+      }
+    }
+
+    passes = 0;
+    samples = 0;
+    start = now_ns();
+    do
+    {
+      samples += sampler_pass(&sampler);
+      passes++;
+      elapsed = now_ns() - start;
+    } while(elapsed < (unsigned long long int) duration_ms * 1000000ULL);
+
+    printf("## BENCH ## %10u | %12.0f | %16.0f | %16.1f ##\n", ntasks, passes * 1e9 / elapsed, samples * 1e9 / elapsed, (double) elapsed / samples);
+  }
+
+  sampler_close(&sampler);
+  kill_children();
+}
+
+void kill_children(void)
+{
+  while(nchildren > 0)
+  {
+    kill(children[--nchildren], SIGKILL);
+    waitpid(children[nchildren], NULL, 0);
+  }
+}
+
+//Raises the soft limit on open files to the hard limit. Returns the limit now in force.
+rlim_t raise_fd_limit(void)
+{
+  struct rlimit limit;
+
+  if(getrlimit(RLIMIT_NOFILE, &limit) == -1)
+    errExit("getrlimit");
+
+  if(limit.rlim_cur < limit.rlim_max)
+  {
+    limit.rlim_cur = limit.rlim_max;
+    if(setrlimit(RLIMIT_NOFILE, &limit) == -1)
+      getrlimit(RLIMIT_NOFILE, &limit);
+  }
+  return limit.rlim_cur;
+}
+
+//Sleeps until an absolute CLOCK_MONOTONIC deadline, so no error accumulates from one pass to the next.
+void sleep_until(unsigned long long int deadline)
+{
+  struct timespec ts;
+
+  ts.tv_sec = (time_t) (deadline / 1000000000ULL);
+  ts.tv_nsec = (long) (deadline % 1000000000ULL);
+  while(clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR)
+    ;
+}
+
+unsigned long long int now_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (unsigned long long int) ts.tv_sec * 1000000000ULL + (unsigned long long int) ts.tv_nsec;
+}
+
+//Function to print the error to STDOUT and exit.
+void errExit(char *strError)
+{
+  perror(strError);
+  exit(EXIT_FAILURE);
+}